@@ -0,0 +1,82 @@
+/* [Description]
+ * This program answers distance queries from an all-pairs result saved by JohnsonAdjacencyList.cpp or
+ * FloydWarshall.cpp (saveResult = true). The file is memory-mapped (apsp_file.h), so opening it costs nothing
+ * beyond reading the header and every query is a single load; pages come from the page cache and are shared
+ * with every other process serving the same file.
+ * Queries are "s t" pairs, taken from the command line or, if none are given there, from stdin. With
+ * --bench K the program instead times K random lookups.
+ *
+ * Usage: ./APSPLookup apsp_johnson.bin 1 42 17 5
+ *        ./APSPLookup apsp_johnson.bin < queries.txt
+ *        ./APSPLookup apsp_johnson.bin --bench 1000000
+ *
+ * Libraries:
+ * - iostream: For reading queries and printing the answers.
+ * - chrono, random: Timing and query generation for --bench.
+ * - string: Argument handling.
+ * - apsp_file.h: The mapped result file.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include "apsp_file.h"
+
+using namespace std;
+using ll = long long;
+
+void Answer(const APSPFile &file, int s, int t) {
+    if (s < 0 || t < 0 || s >= file.VertexCount() || t >= file.VertexCount()) {
+        cout << s << " -> " << t << ": no such vertex\n";
+        return;
+    }
+    ll d = file.Dist(s, t);
+    if (d == APSPFile::UNREACHABLE) cout << s << " -> " << t << ": unreachable\n";
+    else cout << s << " -> " << t << ": " << d << '\n';
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <result file> [s t ...] | [--bench K]\n";
+        return 1;
+    }
+
+    auto openBegin = chrono::steady_clock::now();
+    APSPFile file;
+    if (!file.Open(argv[1])) {
+        cout << "Error: " << argv[1] << " is not an APSP result file.\n";
+        return 1;
+    }
+    auto openEnd = chrono::steady_clock::now();
+
+    if (argc == 4 && string(argv[2]) == "--bench") {
+        ll count = stoll(argv[3]), checksum = 0;
+        mt19937 rng(2025);
+        uniform_int_distribution<int> pick(0, file.VertexCount() - 1);
+        auto begin = chrono::steady_clock::now();
+        for (ll i = 0; i < count; ++i) {
+            ll d = file.Dist(pick(rng), pick(rng));
+            if (d != APSPFile::UNREACHABLE) checksum += d;
+        }
+        auto end = chrono::steady_clock::now();
+        ll ns = chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+        cout << "Vertices = " << file.VertexCount() << ", " << file.ElementBytes() * 8 << "-bit entries\n";
+        cout << "Open = " << chrono::duration_cast<chrono::nanoseconds>(openEnd - openBegin).count() << " ns\n";
+        cout << "Lookups = " << count << ", " << (double)ns / count << " ns per lookup, checksum " << checksum << '\n';
+        return 0;
+    }
+
+    if (argc > 2) {
+        for (int i = 2; i + 1 < argc; i += 2) Answer(file, stoi(argv[i]), stoi(argv[i + 1]));
+        return 0;
+    }
+    int s, t;
+    while (cin >> s >> t) Answer(file, s, t);
+    return 0;
+}
@@ -5,8 +5,11 @@
  * exactly like Dijkstra while preserving the A* structure for future heuristic swaps.
  * Additionally, the program measures the time and memory consumption of this implementation of the
  * algorithm for each test test graph and outputs them.
- * Important note: The method used to measure the memory consumption is OS-dependent and works specifically
- * on Linux, replicating the results on another operating system will require making changes in the program.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ * With BENCH_OUTPUT set, the run is also appended as a record for BenchCompare (bench_report.h).
+ * Work counters (engine_stats.h) are printed when collectStats is on.
+ * The search reads the graph only through ForEachNeighbor (search_workspace.h), so the same loop runs on a
+ * CSRGraph or a DynamicGraph.
  *
  * Author: H. Hristov
  * Ruse, 2025
@@ -17,6 +20,11 @@
 #include <chrono>
 #include <vector>
 #include <queue>
+#include "search_workspace.h"
+#include "shortest_path_tree.h"
+#include "engine_stats.h"
+#include "memory_stats.h"
+#include "bench_report.h"
 
 using namespace std;
 const long long INF = 1e18;
@@ -27,24 +35,7 @@ inline long long Heuristic(int)
     return 0;
 }
 
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
-void PrintMemoryUsage()
-{
-    ifstream status("/proc/self/status");
-    string line;
-    while (getline(status, line))
-    {
-        if (line.find("VmPeak") != string::npos ||
-            line.find("VmRSS") != string::npos)
-        {
-            cout << line << '\n';
-        }
-    }
-}
-
-int main()
+int main(int argc, char **argv)
 {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -53,8 +44,9 @@ int main()
     PrintMemoryUsage();
 
     auto begin = chrono::steady_clock::now();
+    BeginMemoryPhase("load graph");
 
-    const string filePath = "graph_N10000_D0.100000_negfalse_1.in";
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
     ifstream fileStream(filePath);
     int N;
     fileStream >> N;
@@ -67,10 +59,19 @@ int main()
         adjacencyList[u].emplace_back(v, w);
     }
 
+    BeginMemoryPhase("A*");
     vector<long long> dist(N + 1, INF);
     vector<bool> seen(N + 1, false);
     dist[1] = 0;
 
+    // Set to true to record the shortest-path tree; when false the tracker compiles away.
+    constexpr bool trackParents = false;
+    ParentTracker<trackParents> parents(N + 1);
+    // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+    // the counters compile away.
+    constexpr bool collectStats = ENGINE_STATS_ENABLED;
+    EngineStats<collectStats> stats;
+
     // Min-heap ordered by f = g + h
     priority_queue <
         pair<long long, int>,
@@ -78,35 +79,58 @@ int main()
         greater<pair<long long, int>>>
         pq;
     pq.push({dist[1] + Heuristic(1), 1});
+    stats.Push();
 
     while (!pq.empty())
     {
         auto [f, x] = pq.top();
         pq.pop();
+        stats.Pop();
         if (seen[x])
+        {
+            stats.StalePop();
             continue;
+        }
         seen[x] = true;
 
-        for (auto [y, wt] : adjacencyList[x])
+        ForEachNeighbor(adjacencyList, x, [&](int y, long long wt)
         {
+            stats.Relax();
             long long g = dist[x] + wt;
             if (g < dist[y])
             {
                 dist[y] = g;
+                parents.Record(y, x);
+                stats.Improve();
                 pq.push({g + Heuristic(y), y});
+                stats.Push();
             }
-        }
+        });
     }
 
+    EndMemoryPhase();
+    TrackStructure("adjacency list", NestedVectorBytes(adjacencyList));
+    TrackStructure("distances", VectorBytes(dist));
+    TrackStructure("seen", (long long)(seen.capacity() / 8));
+    TrackStructure("priority queue", PriorityQueueBytes(pq));
+
     //  for (int i = 1; i <= N; ++i) {
     //      cout << (dist[i] == INF ? -1 : dist[i]) << " ";
     //  }
     // cout << '\n';
 
+    if (!parents.Dump("spt_astar.bin", 1, dist, INF))
+        cout << "Error: could not write the tree.\n";
+
     auto end = chrono::steady_clock::now();
     cout << "\nMemory usage after algorithm:\n";
     PrintMemoryUsage();
+    PrintMemoryReport();
     cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    stats.Print(cout);
+    WriteBenchRecord({"A*", filePath, N, AdjacencyEdgeCount(adjacencyList), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      stats.Counters({{"queue_bytes", (double)PriorityQueueBytes(pq)}})});
 
     return 0;
 }
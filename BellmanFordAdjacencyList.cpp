@@ -4,15 +4,19 @@
  * detect negative weight cycles.
  * Additionally, the program measures the time and memory consumption of this implementation
  * for each test graph and outputs these metrics.
- * Important note: Memory measurement is OS-dependent and works on Linux via /proc/self/status.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
  *
  * Libraries:
  * - iostream: For printing messages and errors to stdout.
- * - fstream: For reading input graph files and the status file for memory usage.
+ * - fstream: For reading input graph files.
  * - chrono: For measuring elapsed execution time.
  * - vector: For storing the edge list and distance array.
  * - tuple: For representing edges as (from, to, weight) tuples.
  * - string: For file path handling and string operations.
+ * - shortest_path_tree.h: Opt-in parent tracking, path extraction and the binary tree dump.
+ * - engine_stats.h: Opt-in work counters (relaxations, queue operations, passes).
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
  *
  * Author: H. Hristov
  * Ruse, 2025
@@ -23,25 +27,16 @@
 #include <vector>
 #include <tuple>
 #include <string>
+#include "shortest_path_tree.h"
+#include "engine_stats.h"
+#include "memory_stats.h"
+#include "bench_report.h"
 
 using namespace std;
 
 const long long INF = 1e18;
 
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
-void PrintMemoryUsage() {
-    ifstream status("/proc/self/status");
-    string line;
-    while (getline(status, line)) {
-        if (line.find("VmPeak") != string::npos || line.find("VmRSS") != string::npos) {
-            cout << line << '\n';
-        }
-    }
-}
-
-int main() {
+int main(int argc, char **argv) {
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
 
@@ -49,8 +44,9 @@ int main() {
     PrintMemoryUsage();
 
     chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    BeginMemoryPhase("load graph");
 
-    string filePath = "graph_N10000_D0.100000_negtrue_1.in";
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negtrue_1.in";
     ifstream fileStream(filePath);
 
     int N;
@@ -63,18 +59,31 @@ int main() {
         edges.emplace_back(u, v, w);
     }
 
+    BeginMemoryPhase("Bellman-Ford");
     vector<long long> distances(N + 1, INF);
     distances[1] = 0;
 
+    // Set to true to record the shortest-path tree; when false the tracker compiles away.
+    constexpr bool trackParents = false;
+    ParentTracker<trackParents> parents(N + 1);
+    // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+    // the counters compile away.
+    constexpr bool collectStats = ENGINE_STATS_ENABLED;
+    EngineStats<collectStats> stats;
+
     // Bellman-Ford algorithm
     for (int i = 1; i <= N - 1; ++i) {
         bool updated = false;
+        stats.Pass();
         for (auto &edge : edges) {
             int from, to;
             long long weight;
             tie(from, to, weight) = edge;
+            stats.Relax();
             if (distances[from] != INF && distances[to] > distances[from] + weight) {
                 distances[to] = distances[from] + weight;
+                parents.Record(to, from);
+                stats.Improve();
                 updated = true;
             }
         }
@@ -92,6 +101,10 @@ int main() {
         }
     }
 
+    EndMemoryPhase();
+    TrackStructure("edge list", VectorBytes(edges));
+    TrackStructure("distances", VectorBytes(distances));
+
     // for (int i = 1; i <= N; ++i) {
     //     if (distances[i] == INF) cout << "INF ";
     //     else cout << distances[i] << " ";
@@ -102,10 +115,18 @@ int main() {
         cout << "Warning: negative weight cycle detected." << '\n';
     }
 
+    if (!negCycle && !parents.Dump("spt_bellmanford.bin", 1, distances, INF))
+        cout << "Error: could not write the tree.\n";
+
     chrono::steady_clock::time_point end = chrono::steady_clock::now();
     cout << "\nMemory usage after algorithm:\n";
     PrintMemoryUsage();
+    PrintMemoryReport();
     cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    stats.Print(cout);
+    WriteBenchRecord({"Bellman-Ford", filePath, N, (long long)edges.size(), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      stats.Counters({{"negative_cycle", (double)negCycle}})});
 
     return 0;
 }
@@ -0,0 +1,156 @@
+/* [Description]
+ * This program compares two sets of benchmark records written by bench_report.h (BENCH_OUTPUT, JSON Lines or
+ * CSV) and reports statistically significant regressions. Records are grouped by (algorithm, graph, threads);
+ * for every group the total time and the time of each phase are compared with Welch's t-test, which does not
+ * assume equal variances in the two runs. A metric is a regression when the candidate mean is slower by more
+ * than the threshold and the two-sided p-value is below alpha; faster metrics are listed as improvements.
+ * Groups with fewer than two samples on either side cannot be tested and are only reported.
+ * The exit code is 1 if any regression was found, so the program can gate a script or CI job:
+ *     for i in 1 2 3 4 5; do BENCH_OUTPUT=base.jsonl ./DijkstraAdjacencyList; done
+ *     (rebuild)
+ *     for i in 1 2 3 4 5; do BENCH_OUTPUT=new.jsonl ./DijkstraAdjacencyList; done
+ *     ./BenchCompare base.jsonl new.jsonl
+ *
+ * Usage: ./BenchCompare <baseline file> <candidate file> [alpha = 0.05] [threshold = 0.02]
+ *
+ * Libraries:
+ * - iostream: Printing the report.
+ * - string, vector, map: Samples grouped per benchmark and metric.
+ * - cmath, cstdlib: Statistics (lgamma, the incomplete beta function) and argument parsing.
+ * - bench_report.h: ReadBenchResults for both record formats.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include "bench_report.h"
+
+using namespace std;
+
+// Samples per group ("algorithm | graph | threads") and metric ("total_ns", "phase:<name>").
+using Samples = map<string, map<string, vector<double>>>;
+
+bool ReadSamples(const string &path, Samples &samples) {
+    vector<BenchResult> results;
+    if (!ReadBenchResults(path, results)) return false;
+    for (const BenchResult &r : results) {
+        string group = r.record.algorithm + " | " + r.record.graph + " | " + to_string(r.record.threads);
+        samples[group]["total_ns"].push_back((double)r.record.totalNs);
+        for (auto &[name, ns] : r.phaseNs) samples[group]["phase:" + name].push_back(ns);
+    }
+    return true;
+}
+
+// Regularized incomplete beta function I_x(a, b), continued fraction (Numerical Recipes, betacf).
+double IncompleteBeta(double a, double b, double x) {
+    if (x <= 0) return 0;
+    if (x >= 1) return 1;
+    if (x > (a + 1) / (a + b + 2)) return 1 - IncompleteBeta(b, a, 1 - x);
+    double front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x)) / a;
+    const double tiny = 1e-300;
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    if (fabs(d) < tiny) d = tiny;
+    d = 1 / d;
+    double f = d;
+    for (int m = 1; m <= 300; ++m) {
+        for (int step = 0; step < 2; ++step) {
+            double num = step == 0 ? m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m))
+                                   : -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+            d = 1 + num * d;
+            if (fabs(d) < tiny) d = tiny;
+            c = 1 + num / c;
+            if (fabs(c) < tiny) c = tiny;
+            d = 1 / d;
+            f *= c * d;
+            if (step == 1 && fabs(c * d - 1) < 1e-12) return front * f;
+        }
+    }
+    return front * f;
+}
+
+struct Summary { double mean = 0, variance = 0; size_t n = 0; };
+
+Summary Summarize(const vector<double> &x) {
+    Summary s;
+    s.n = x.size();
+    for (double v : x) s.mean += v;
+    s.mean /= s.n;
+    for (double v : x) s.variance += (v - s.mean) * (v - s.mean);
+    s.variance = s.n > 1 ? s.variance / (s.n - 1) : 0;
+    return s;
+}
+
+// Two-sided p-value of Welch's t-test, with the Welch-Satterthwaite degrees of freedom.
+double WelchPValue(const Summary &a, const Summary &b) {
+    double va = a.variance / a.n, vb = b.variance / b.n;
+    if (va + vb == 0) return a.mean == b.mean ? 1 : 0;
+    double t = (b.mean - a.mean) / sqrt(va + vb);
+    double df = (va + vb) * (va + vb) / (va * va / (a.n - 1) + vb * vb / (b.n - 1));
+    return IncompleteBeta(df / 2, 0.5, df / (df + t * t));
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " <baseline file> <candidate file> [alpha = 0.05] [threshold = 0.02]\n";
+        return 2;
+    }
+    double alpha = argc > 3 ? atof(argv[3]) : 0.05;
+    double threshold = argc > 4 ? atof(argv[4]) : 0.02;
+
+    Samples baseline, candidate;
+    for (auto [path, samples] : {pair<const char *, Samples *>{argv[1], &baseline}, {argv[2], &candidate}}) {
+        if (!ReadSamples(path, *samples)) {
+            cout << "Error: could not read " << path << '\n';
+            return 2;
+        }
+    }
+
+    int regressions = 0, improvements = 0, untested = 0;
+    for (auto &[group, metrics] : candidate) {
+        auto base = baseline.find(group);
+        if (base == baseline.end()) {
+            cout << "[new]        " << group << '\n';
+            continue;
+        }
+        for (auto &[metric, values] : metrics) {
+            auto old = base->second.find(metric);
+            if (old == base->second.end()) continue;
+            Summary a = Summarize(old->second), b = Summarize(values);
+            double change = a.mean > 0 ? b.mean / a.mean - 1 : 0;
+            cout.setf(ios::fixed);
+            cout.precision(1);
+            if (a.n < 2 || b.n < 2) {
+                ++untested;
+                cout << "[untested]   " << group << " | " << metric << ": " << 100 * change << "% (" << a.n << " vs "
+                     << b.n << " samples, need at least 2 each)\n";
+                continue;
+            }
+            double p = WelchPValue(a, b);
+            const char *verdict = "[same]       ";
+            if (p < alpha && change > threshold) {
+                verdict = "[REGRESSION] ";
+                ++regressions;
+            } else if (p < alpha && change < -threshold) {
+                verdict = "[improved]   ";
+                ++improvements;
+            }
+            cout << verdict << group << " | " << metric << ": " << a.mean << " -> " << b.mean << " ns ("
+                 << (change >= 0 ? "+" : "") << 100 * change << "%, ";
+            cout.precision(4);
+            cout << "p = " << p << ", " << a.n << " vs " << b.n << " samples)\n";
+        }
+    }
+    for (auto &[group, metrics] : baseline)
+        if (!candidate.count(group)) cout << "[missing]    " << group << '\n';
+
+    cout.unsetf(ios::fixed);
+    cout.precision(6);
+    cout << "\nRegressions = " << regressions << ", improvements = " << improvements << ", untested = " << untested
+         << " (alpha = " << alpha << ", threshold = " << 100 * threshold << "%)\n";
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+/* [Description]
+ * This program measures what the compressed CSR of compressed_csr.h (varint target gaps + narrow weights) saves
+ * in memory and what its on-the-fly decoding costs, against the plain CSR of graph_csr.h:
+ * - memory of the adjacency arrays of both representations,
+ * - a full edge scan (pure decode throughput, ns per edge),
+ * - the generic engines on both: Dijkstra from a few sources on graphs with non-negative weights, SPFA
+ *   potentials (johnson_potentials.h) on graphs with negative ones; the results must be identical.
+ * The weight type is the narrowest of int8/int16/int32/int64 that holds every weight of the input.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, string, cstdint: Results, file path handling and the weight types.
+ * - graph_csr.h, compressed_csr.h: Both graph representations.
+ * - search_workspace.h, johnson_potentials.h: The generic Dijkstra and SPFA.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "graph_csr.h"
+#include "compressed_csr.h"
+#include "search_workspace.h"
+#include "johnson_potentials.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+
+ll ElapsedNs(chrono::steady_clock::time_point from) {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - from).count();
+}
+
+// Runs the engines on one representation. Returns the concatenated results so both can be compared.
+template<typename Graph>
+vector<ll> RunEngines(const Graph &g, const string &name, bool negative, int sources, int scans) {
+    BeginMemoryPhase(name + " engines");
+    int n = VertexCount(g);
+    ll edges = 0, checksum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < scans; ++r) {
+        for (int u = 0; u < n; ++u) {
+            ForEachNeighbor(g, u, [&](int v, ll w) {
+                checksum += v ^ w;
+                ++edges;
+            });
+        }
+    }
+    ll scanNs = ElapsedNs(begin);
+    cout << name << ": edge scan = " << (double)scanNs / edges << " ns/edge (checksum " << checksum << ")\n";
+
+    vector<ll> results;
+    begin = chrono::steady_clock::now();
+    if (negative) {
+        if (!SPFAPotentials(g, results, false)) cout << "Warning: negative weight cycle detected.\n";
+        cout << name << ": SPFA potentials = " << ElapsedNs(begin) << " ns\n";
+        return results;
+    }
+    SearchWorkspace ws(n);
+    for (int i = 0; i < sources; ++i) {
+        Dijkstra(g, 1 + (int)((ll)i * (n - 1) / sources), ws);
+        for (int v = 0; v < n; ++v) results.push_back(ws.Dist(v));
+    }
+    cout << name << ": Dijkstra from " << sources << " sources = " << ElapsedNs(begin) << " ns\n";
+    return results;
+}
+
+template<typename W>
+bool Compare(const CSRGraph &csr, const vector<Edge> &edges, bool negative, int sources, int scans) {
+    BeginMemoryPhase("build compressed CSR");
+    auto buildBegin = chrono::steady_clock::now();
+    CompressedCSRGraph<W> compressed = BuildCompressedCSR<W>(csr.VertexCount(), edges);
+    ll buildNs = ElapsedNs(buildBegin);
+
+    size_t csrBytes = csr.offsets.size() * sizeof(int) + csr.targets.size() * sizeof(int) +
+                      csr.weights.size() * sizeof(ll);
+    cout << "CSR = " << csrBytes << " bytes, compressed CSR (" << sizeof(W) * 8 << "-bit weights) = "
+         << compressed.Bytes() << " bytes (" << (double)csrBytes / compressed.Bytes() << "x smaller, "
+         << (double)compressed.bytes.size() / edges.size() << " bytes per edge), built in " << buildNs << " ns\n";
+
+    TrackStructure("CSR graph", (ll)csr.Bytes());
+    TrackStructure("compressed CSR graph", (ll)compressed.Bytes());
+
+    vector<ll> plain = RunEngines(csr, "CSR", negative, sources, scans);
+    vector<ll> packed = RunEngines(compressed, "Compressed CSR", negative, sources, scans);
+    return plain == packed;
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    auto begin = chrono::steady_clock::now();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
+    const int sources = 20, scans = 5;
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+    CSRGraph csr = BuildCSR(N+1, edges);
+    bool negative = false;
+    for (const Edge &e : edges) negative |= (e.weight < 0);
+
+    bool same;
+    if (WeightsFit<int8_t>(edges)) same = Compare<int8_t>(csr, edges, negative, sources, scans);
+    else if (WeightsFit<int16_t>(edges)) same = Compare<int16_t>(csr, edges, negative, sources, scans);
+    else if (WeightsFit<int32_t>(edges)) same = Compare<int32_t>(csr, edges, negative, sources, scans);
+    else same = Compare<int64_t>(csr, edges, negative, sources, scans);
+    if (!same) {
+        cout << "Error: the compressed graph gave different results.\n";
+        return 1;
+    }
+
+    auto end = chrono::steady_clock::now();
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    WriteBenchRecord({"compressed CSR", filePath, N, (long long)edges.size(), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"sources", (double)sources}, {"scans", (double)scans}}});
+
+    return 0;
+}
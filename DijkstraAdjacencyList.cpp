@@ -4,14 +4,18 @@
  * the shortest path to a specific ending node for more efficiency if that's all we need.
  * Additionally, the program measures the time and memory consumption of this implementation of the
  * algorithm for each test test graph and outputs them.
- * Important note: The method used to measure the memory consumption is OS-dependent and works specifically
- * on Linux, replicating the results on another operating system will require making changes in the program.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
  * 
  * Libraries:
  * - iostream: To print out messages and errors in the stdout.
- * - fstream: Reading from the status file and test graph files.
+ * - fstream: Reading the test graph files.
  * - chrono: Measure elapsed time.
  * - vector, queue: Necessary data structures to implement the algorithm.
+ * - shortest_path_tree.h: Opt-in parent tracking, path extraction and the binary tree dump.
+ * - engine_stats.h: Opt-in work counters (relaxations, queue operations, passes).
+ * - relax_prefetch.h: Opt-in software prefetching in the relaxation loop.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
  * 
  * Author: H. Hristov
  * Ruse, 2025
@@ -21,26 +25,18 @@
 #include <chrono>
 #include <vector>
 #include <queue>
+#include "shortest_path_tree.h"
+#include "engine_stats.h"
+#include "relax_prefetch.h"
+#include "memory_stats.h"
+#include "bench_report.h"
 
 
 using namespace std;
 
 const long long INF = 1e18;
 
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
-void PrintMemoryUsage() {
-    ifstream status("/proc/self/status");
-    string line;
-    while (getline(status, line)) {
-        if (line.find("VmPeak") != string::npos || line.find("VmRSS") != string::npos) {
-            cout << line << '\n';
-        }
-    }
-}
-
-int main() {
+int main(int argc, char **argv) {
     ios_base::sync_with_stdio(0);
     cin.tie(0);
     cout.tie(0);
@@ -48,8 +44,9 @@ int main() {
     PrintMemoryUsage();
     
     chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    BeginMemoryPhase("load graph");
     
-    string filePath = "graph_N10000_D0.100000_negfalse_1.in";
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
     ifstream fileStream(filePath);
     
     int N;
@@ -62,6 +59,7 @@ int main() {
         adjacencyList[fromNode].push_back({toNode, edgeWeight});
     }
     
+    BeginMemoryPhase("Dijkstra");
     vector<long long> distances(N + 1, INF);
     distances[1] = 0;
     
@@ -69,18 +67,44 @@ int main() {
     pq.push({0, 1});
     
     vector<bool> visited(N + 1, false);
+
+    // Set to true to record the shortest-path tree; when false the tracker compiles away.
+    constexpr bool trackParents = false;
+    ParentTracker<trackParents> parents(N + 1);
+    // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+    // the counters compile away.
+    constexpr bool collectStats = ENGINE_STATS_ENABLED;
+    EngineStats<collectStats> stats;
+    // Set to k > 0 (or build with -DPREFETCH_DISTANCE=k) to prefetch distances k edges ahead and the next
+    // vertex's adjacency row; when 0 the prefetches compile away.
+    constexpr int prefetchDistance = PREFETCH_DISTANCE_DEFAULT;
+    RelaxPrefetcher<prefetchDistance> prefetch;
+    stats.Push();   // the source
     
     while (!pq.empty()) {
         auto [d, u] = pq.top();
         pq.pop();
+        stats.Pop();
         
-        if (visited[u]) continue;
+        if (visited[u]) {
+            stats.StalePop();
+            continue;
+        }
         visited[u] = true;
+        if (!pq.empty()) prefetch.Next(adjacencyList, pq.top().second, distances);
         
-        for (auto [v, w] : adjacencyList[u]) {
+        const auto &row = adjacencyList[u];
+        prefetch.Start(row, distances);
+        for (size_t i = 0; i < row.size(); ++i) {
+            prefetch.Ahead(row, i, distances);
+            auto [v, w] = row[i];
+            stats.Relax();
             if (distances[v] > distances[u] + w) {
                 distances[v] = distances[u] + w;
+                parents.Record(v, u);
+                stats.Improve();
                 pq.push({distances[v], v});
+                stats.Push();
             }
         }
     }
@@ -91,10 +115,23 @@ int main() {
     // }
     // cout << endl;
 
+    EndMemoryPhase();
+    TrackStructure("adjacency list", NestedVectorBytes(adjacencyList));
+    TrackStructure("distances", VectorBytes(distances));
+    TrackStructure("visited", (long long)(visited.capacity() / 8));
+    TrackStructure("priority queue", PriorityQueueBytes(pq));
+
+    if (!parents.Dump("spt_dijkstra.bin", 1, distances, INF)) cout << "Error: could not write the tree.\n";
+
     chrono::steady_clock::time_point end = chrono::steady_clock::now();
     cout << "\nMemory usage after algorithm:\n";
     PrintMemoryUsage();
+    PrintMemoryReport();
     cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds> (end - begin).count() << " ns" << '\n';
+    stats.Print(cout);
+    WriteBenchRecord({"Dijkstra", filePath, N, AdjacencyEdgeCount(adjacencyList), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      stats.Counters({{"prefetch_distance", (double)prefetchDistance}})});
 
     return 0;
 }
\ No newline at end of file
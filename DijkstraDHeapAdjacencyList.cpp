@@ -5,14 +5,18 @@
  * instantiation.
  * Additionally, the program measures the time and memory consumption of this implementation of the
  * algorithm for each test test graph and outputs them.
- * Important note: The method used to measure the memory consumption is OS-dependent and works specifically
- * on Linux, replicating the results on another operating system will require making changes in the program.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
  *
  * Libraries:
- * - iostream, fstream: I/O for graph and /proc/self/status
+ * - iostream, fstream: I/O for graph
  * - chrono: high-resolution timing
  * - vector, algorithm: data structures and utilities
  * - limits, stdexcept: constants and exceptions
+ * - shortest_path_tree.h: Opt-in parent tracking, path extraction and the binary tree dump.
+ * - engine_stats.h: Opt-in work counters (relaxations, queue operations, passes).
+ * - relax_prefetch.h: Opt-in software prefetching in the relaxation loop.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
  *
  * Author: H. Hristov
  * Ruse, 2025
@@ -26,23 +30,15 @@
  #include <limits>
  #include <stdexcept>
  #include <algorithm>
+ #include "shortest_path_tree.h"
+ #include "engine_stats.h"
+ #include "relax_prefetch.h"
+ #include "memory_stats.h"
+ #include "bench_report.h"
  
  using namespace std;
  static constexpr long long INF = numeric_limits<long long>::max();
  
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
- void PrintMemoryUsage() {
-     ifstream status("/proc/self/status");
-     string line;
-     while (getline(status, line)) {
-         if (line.rfind("VmPeak", 0) == 0 || line.rfind("VmRSS", 0) == 0) {
-             cout << line << '\n';
-         }
-     }
- }
- 
  // Indexed D-ary min-heap supporting insert, decrease-key, and poll-min
  template<typename T>
  class MinIndexedDHeap {
@@ -122,23 +118,32 @@
          return minki;
      }
  
+     // Key index of the minimum, without removing it.
+     int peekMinKey() const {
+         if (size_ == 0) throw out_of_range("Heap underflow");
+         return im[0];
+     }
+ 
      T pollMinValue() {
          int ki = pollMinKey();
          return values[ki];
      }
  
      bool empty() const { return size_ == 0; }
+     // Bytes held by the position, inverse and key arrays.
+     size_t Bytes() const { return (pm.capacity() + im.capacity()) * sizeof(int) + values.capacity() * sizeof(T); }
  };
  
- int main() {
+ int main(int argc, char **argv) {
      ios::sync_with_stdio(false);
      cin.tie(nullptr);
  
      cout << "Memory usage at start:\n";
      PrintMemoryUsage();
      auto begin = chrono::steady_clock::now();
+     BeginMemoryPhase("load graph");
  
-     string filePath = "graph_N10000_D0.100000_negfalse_1.in";
+     string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
      ifstream fs(filePath);
      int N;
      fs >> N;
@@ -149,44 +154,85 @@
          adj[u].emplace_back(v,w);
      }
  
+     BeginMemoryPhase("Dijkstra (d-ary heap)");
      vector<long long> dist(N+1, INF);
-     vector<int> prev(N+1, -1);
+     // Set to true to record the shortest-path tree; when false the tracker compiles away.
+     constexpr bool trackParents = false;
+     ParentTracker<trackParents> parents(N+1);
+     // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+     // the counters compile away.
+     constexpr bool collectStats = ENGINE_STATS_ENABLED;
+     EngineStats<collectStats> stats;
+     // Set to k > 0 (or build with -DPREFETCH_DISTANCE=k) to prefetch distances k edges ahead and the next
+     // vertex's adjacency row; when 0 the prefetches compile away.
+     constexpr int prefetchDistance = PREFETCH_DISTANCE_DEFAULT;
+     RelaxPrefetcher<prefetchDistance> prefetch;
      dist[1] = 0;
  
      // degree estimate: avg edges per node
      int degree = max(2, (int)(adj[1].size()));
      MinIndexedDHeap<long long> heap(degree, N+1);
      heap.insert(1, 0LL);
+     stats.Push();
  
      vector<char> visited(N+1, 0);
      while (!heap.empty()) {
          int x = heap.pollMinKey();
-         if (visited[x]) continue;
+         stats.Pop();
+         if (visited[x]) {
+             stats.StalePop();
+             continue;
+         }
          visited[x] = 1;
-         for (auto &e : adj[x]) {
+         if (!heap.empty()) prefetch.Next(adj, heap.peekMinKey(), dist);
+         const auto &row = adj[x];
+         prefetch.Start(row, dist);
+         for (size_t i = 0; i < row.size(); ++i) {
+             prefetch.Ahead(row, i, dist);
+             auto &e = row[i];
+             stats.Relax();
              int to = e.first;
              long long wt = e.second;
              if (visited[to]) continue;
              long long nd = dist[x] + wt;
              if (nd < dist[to]) {
                  dist[to] = nd;
-                 prev[to] = x;
-                 if (heap.contains(to)) heap.decrease(to, nd);
-                 else heap.insert(to, nd);
+                 parents.Record(to, x);
+                 stats.Improve();
+                 if (heap.contains(to)) {
+                     heap.decrease(to, nd);
+                     stats.DecreaseKey();
+                 } else {
+                     heap.insert(to, nd);
+                     stats.Push();
+                 }
              }
          }
      }
  
+     EndMemoryPhase();
+     TrackStructure("adjacency list", NestedVectorBytes(adj));
+     TrackStructure("distances", VectorBytes(dist));
+     TrackStructure("visited", VectorBytes(visited));
+     TrackStructure("d-ary heap", (long long)heap.Bytes());
+
     //  for (int i = 1; i <= N; ++i) {
     //      if (dist[i] == INF) cout << "-1 ";
     //      else cout << dist[i] << ' ';
     //  }
     //  cout << '\n';
  
+     if (!parents.Dump("spt_dheap.bin", 1, dist, INF)) cout << "Error: could not write the tree.\n";
+
      auto end = chrono::steady_clock::now();
      cout << "\nMemory usage after algorithm:\n";
      PrintMemoryUsage();
+     PrintMemoryReport();
      cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+     stats.Print(cout);
+     WriteBenchRecord({"Dijkstra (d-ary heap)", filePath, N, AdjacencyEdgeCount(adj), 1,
+                       chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                       stats.Counters({{"prefetch_distance", (double)prefetchDistance}})});
      return 0;
  }
  
\ No newline at end of file
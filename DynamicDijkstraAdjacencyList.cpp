@@ -0,0 +1,259 @@
+/* [Description]
+ * This program maintains single-source shortest paths (Dijkstra, non-negative weights) while the graph changes,
+ * in the spirit of Ramalingam and Reps: after an edge update only the part of the shortest-path tree that the
+ * update can affect is recomputed, instead of rerunning Dijkstra on the whole graph.
+ * - Insertion or weight decrease of (u, v): if it shortens the path to v, v gets the new distance and a
+ *   Dijkstra seeded with v alone propagates the improvement; nothing else can change.
+ * - Deletion or weight increase of (u, v): if (u, v) is not a tree edge nothing changes. Otherwise every vertex
+ *   in v's subtree loses its distance; each one is seeded with its best in-edge from outside the subtree and a
+ *   Dijkstra restricted to the subtree settles them again.
+ * The benchmark applies a random stream of updates to the graph, compares the time with one full Dijkstra
+ * per update and verifies the maintained distances against a full recomputation at the end.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - fstream: For reading input graph files.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, algorithm, functional: Adjacency lists, the heap and the subtree stack.
+ * - random, string: Update stream generation and file path handling.
+ * - graph_csr.h, dynamic_graph.h: Fast loader and the mutable graph store (CSR base + per-vertex delta log).
+ * - search_workspace.h: Full Dijkstra used for the initial tree and for verification.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include "graph_csr.h"
+#include "dynamic_graph.h"
+#include "search_workspace.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+const ll INF = SearchWorkspace::INF;
+
+class DynamicSSSP {
+public:
+    DynamicSSSP(int vertexCount, const vector<Edge> &edges, int source)
+        : out_(vertexCount, edges), in_(vertexCount, Reversed(edges)), source_(source),
+          dist_(vertexCount, INF), parent_(vertexCount, -1), inSubtree_(vertexCount, 0) {
+        SearchWorkspace ws(vertexCount);
+        Dijkstra(out_, source_, ws);
+        for (int v = 0; v < vertexCount; ++v) {
+            dist_[v] = ws.Dist(v);
+            parent_[v] = ws.Parent(v);
+        }
+    }
+
+    const DynamicGraph &Graph() const { return out_; }
+    ll Dist(int v) const { return dist_[v]; }
+    int LastAffected() const { return lastAffected_; }
+    // Bytes held by both graphs and the maintained tree.
+    size_t Bytes() const {
+        return out_.Bytes() + in_.Bytes() + dist_.capacity() * sizeof(ll) +
+               (parent_.capacity() + subtree_.capacity()) * sizeof(int) + inSubtree_.capacity() +
+               heap_.capacity() * sizeof(pair<ll,int>);
+    }
+
+    // Inserts (u, v) with weight w, or changes its weight if it already exists.
+    void SetEdge(int u, int v, ll w) {
+        ll old = INF;
+        out_.SetEdge(u, v, w, &old);
+        in_.SetEdge(v, u, w);
+        lastAffected_ = 0;
+        if (w < old) Decreased(u, v, w);
+        else if (w > old && parent_[v] == u) RepairSubtree(v);
+    }
+
+    void RemoveEdge(int u, int v) {
+        out_.RemoveEdge(u, v);
+        in_.RemoveEdge(v, u);
+        lastAffected_ = 0;
+        if (parent_[v] == u) RepairSubtree(v);
+    }
+
+private:
+    DynamicGraph out_, in_;
+    int source_, lastAffected_ = 0;
+    vector<ll> dist_;
+    vector<int> parent_, subtree_;
+    vector<char> inSubtree_;
+    vector<pair<ll,int>> heap_;
+
+    static vector<Edge> Reversed(vector<Edge> edges) {
+        for (Edge &e : edges) swap(e.from, e.to);
+        return edges;
+    }
+
+    void Push(ll d, int v) {
+        heap_.emplace_back(d, v);
+        push_heap(heap_.begin(), heap_.end(), greater<pair<ll,int>>());
+    }
+
+    // Dijkstra from the vertices already in the heap; only strictly shorter distances are propagated.
+    void Propagate() {
+        while (!heap_.empty()) {
+            pop_heap(heap_.begin(), heap_.end(), greater<pair<ll,int>>());
+            auto [d, x] = heap_.back();
+            heap_.pop_back();
+            if (d != dist_[x]) continue;
+            ++lastAffected_;
+            out_.ForEachNeighbor(x, [&, d = d, x = x](int y, ll w) {
+                if (d + w < dist_[y]) {
+                    dist_[y] = d + w;
+                    parent_[y] = x;
+                    Push(dist_[y], y);
+                }
+            });
+        }
+    }
+
+    void Decreased(int u, int v, ll w) {
+        if (dist_[u] == INF || dist_[u] + w >= dist_[v]) return;
+        dist_[v] = dist_[u] + w;
+        parent_[v] = u;
+        Push(dist_[v], v);
+        Propagate();
+    }
+
+    void RepairSubtree(int root) {
+        // Collect the subtree of root in the shortest-path tree.
+        subtree_.assign(1, root);
+        inSubtree_[root] = 1;
+        for (size_t i = 0; i < subtree_.size(); ++i) {
+            int x = subtree_[i];
+            out_.ForEachNeighbor(x, [&](int y, ll) {
+                if (parent_[y] == x && !inSubtree_[y]) {
+                    inSubtree_[y] = 1;
+                    subtree_.push_back(y);
+                }
+            });
+        }
+        for (int x : subtree_) {
+            dist_[x] = INF;
+            parent_[x] = -1;
+        }
+        // Seed every vertex with its best in-edge from outside the subtree, then settle the subtree again.
+        for (int x : subtree_) {
+            in_.ForEachNeighbor(x, [&](int p, ll w) {
+                if (!inSubtree_[p] && dist_[p] != INF && dist_[p] + w < dist_[x]) {
+                    dist_[x] = dist_[p] + w;
+                    parent_[x] = p;
+                }
+            });
+            if (dist_[x] != INF) Push(dist_[x], x);
+        }
+        for (int x : subtree_) inSubtree_[x] = 0;
+        Propagate();
+    }
+};
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
+    const int updateCount = 2000;
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+
+    // Random stream: a quarter each of insertions, deletions, weight increases and weight decreases.
+    // It is generated up front on a plain copy of the graph so that only the updates themselves are timed.
+    struct Update { int kind, from, to; ll weight; };
+    vector<Update> updates;
+    AdjacencyList mirror(N+1);
+    for (const Edge &e : edges) mirror[e.from].emplace_back(e.to, e.weight);
+    mt19937 rng(2025);
+    uniform_int_distribution<int> pickVertex(0, N), pickWeight(1, 10), pickKind(0, 3);
+    while ((int)updates.size() < updateCount) {
+        int kind = pickKind(rng), x = pickVertex(rng);
+        auto &out = mirror[x];
+        if (kind == 0 || out.empty()) {
+            int y = pickVertex(rng);
+            if (y == x) continue;
+            bool exists = false;
+            for (auto &e : out) exists |= (e.first == y);
+            if (exists) continue;
+            out.emplace_back(y, pickWeight(rng));
+            updates.push_back({0, x, y, out.back().second});
+            continue;
+        }
+        size_t i = rng() % out.size();
+        auto [y, oldWeight] = out[i];
+        if (kind == 1) {
+            out[i] = out.back();
+            out.pop_back();
+            updates.push_back({1, x, y, 0});
+        } else {
+            out[i].second = kind == 2 ? oldWeight + pickWeight(rng) : max(1LL, oldWeight - pickWeight(rng));
+            updates.push_back({kind, x, y, out[i].second});
+        }
+    }
+
+    BeginMemoryPhase("build dynamic SSSP");
+    DynamicSSSP sssp(N+1, edges, 1);
+    ll affectedTotal = 0;
+    BeginMemoryPhase("updates");
+    auto begin = chrono::steady_clock::now();
+    for (const Update &up : updates) {
+        if (up.kind == 1) sssp.RemoveEdge(up.from, up.to);
+        else sssp.SetEdge(up.from, up.to, up.weight);
+        affectedTotal += sssp.LastAffected();
+    }
+    auto end = chrono::steady_clock::now();
+
+    // One full Dijkstra on the final graph, both as the cost of the naive approach and for verification.
+    BeginMemoryPhase("full Dijkstra");
+    SearchWorkspace ws(N+1);
+    auto fullBegin = chrono::steady_clock::now();
+    Dijkstra(sssp.Graph(), 1, ws);
+    auto fullEnd = chrono::steady_clock::now();
+    EndMemoryPhase();
+    TrackStructure("dynamic SSSP (both graphs and the tree)", (ll)sssp.Bytes());
+    TrackStructure("search workspace", (ll)ws.Bytes());
+    int mismatches = 0;
+    for (int x = 0; x <= N; ++x) {
+        if (ws.Dist(x) != sssp.Dist(x)) ++mismatches;
+    }
+    if (mismatches) {
+        cout << "Error: " << mismatches << " maintained distances differ from a full recomputation.\n";
+        return 1;
+    }
+
+    ll dynamicNs = chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+    ll fullNs = chrono::duration_cast<chrono::nanoseconds>(fullEnd - fullBegin).count();
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Updates = " << updateCount << ", average vertices resettled = " << (double)affectedTotal / updateCount
+         << '\n';
+    cout << "Dynamic updates = " << dynamicNs << " ns, " << dynamicNs / updateCount << " ns/update\n";
+    cout << "Full Dijkstra = " << fullNs << " ns per update\n";
+    cout << "Graph compactions = " << sssp.Graph().Compactions() << '\n';
+    WriteBenchRecord({"dynamic Dijkstra", filePath, N, (ll)edges.size(), 1, dynamicNs,
+                      {{"updates", (double)updateCount}, {"ns_per_update", (double)dynamicNs / updateCount},
+                       {"avg_resettled", (double)affectedTotal / updateCount}, {"full_dijkstra_ns", (double)fullNs},
+                       {"compactions", (double)sssp.Graph().Compactions()}}});
+
+    return 0;
+}
@@ -1,16 +1,30 @@
 /* [Description]
  * This program computes shortest paths for all pairs in a graph using the FloydWarshall algorithm.
+ * For matrices larger than RAM it has an external-memory mode: the int32 distance matrix is stored as square
+ * tiles in a file and processed with the blocked Floyd-Warshall schedule. Each round keeps only the pivot block
+ * row and block column in memory plus three tile buffers, so that reading the next tile and writing the previous
+ * one overlap with the min-plus update of the current tile. The tile size is derived from a RAM budget.
+ * Optionally, the in-memory mode also keeps a next-hop matrix so that shortest paths, not only their lengths,
+ * can be reconstructed. Either mode can save the final matrix in the apsp_file.h format for APSPLookup.
  * Additionally, the program measures the time and memory consumption of this implementation
  * for each test graph and outputs these metrics.
- * Important note: Memory measurement is OS-dependent and works on Linux via /proc/self/status.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
  *
  * Libraries:
  * - iostream: For printing messages and errors to stdout.
- * - fstream: For reading the input graph file and the status file for memory usage.
+ * - fstream: For reading the input graph file.
  * - chrono: For measuring elapsed execution time.
  * - vector: For storing the distance matrix.
  * - limits: For INF definition.
  * - string: For file path handling.
+ * - future: For overlapping tile I/O with computation in external-memory mode.
+ * - fcntl.h, unistd.h: pread/pwrite/posix_fadvise on the tile file (Linux/POSIX).
+ * - graph_csr.h, min_plus.h: Fast loader, and the min-plus kernels used on tiles.
+ * - apsp_paths.h: Next-hop matrix for path reconstruction.
+ * - apsp_file.h: Saving the result matrix for APSPLookup.
+ * - engine_stats.h: Opt-in work counters (relaxations, queue operations, passes).
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
  *
  * Author: H. Hristov
  * Ruse, 2025
@@ -22,25 +36,308 @@
  #include <vector>
  #include <limits>
  #include <string>
+ #include <future>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include "graph_csr.h"
+ #include "min_plus.h"
+ #include "apsp_paths.h"
+ #include "apsp_file.h"
+ #include "engine_stats.h"
+ #include "memory_stats.h"
+ #include "bench_report.h"
  
  using namespace std;
  using ll = long long;
  const ll INF = numeric_limits<ll>::max() / 4;
  
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
- void PrintMemoryUsage() {
-     ifstream status("/proc/self/status");
-     string line;
-     while (getline(status, line)) {
-         if (line.find("VmPeak") != string::npos || line.find("VmRSS") != string::npos) {
-             cout << line << "\n";
+ /* Stores a padded n x n int32 matrix as T x T tiles in a file; tile (bi, bj) is at offset
+  * (bi * tiles + bj) * T * T * 4 so that every tile is one contiguous read or write.
+  */
+ class TileFile {
+ public:
+     TileFile(const string &path, int paddedN, int tileSize)
+         : path_(path), tileSize_(tileSize), tiles_(paddedN / tileSize),
+           tileBytes_((size_t)tileSize * tileSize * sizeof(int32_t)) {
+         fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+         if (fd_ >= 0 && ftruncate(fd_, (off_t)(tileBytes_ * tiles_ * tiles_)) != 0) {
+             close(fd_);
+             fd_ = -1;
+         }
+     }
+     ~TileFile() {
+         if (fd_ >= 0) close(fd_);
+         unlink(path_.c_str());
+     }
+
+     bool IsOpen() const { return fd_ >= 0; }
+     int Tiles() const { return tiles_; }
+     int TileSize() const { return tileSize_; }
+     size_t TileElements() const { return (size_t)tileSize_ * tileSize_; }
+
+     bool Read(int bi, int bj, int32_t *buffer) const { return Transfer(bi, bj, (char *)buffer, false); }
+     bool Write(int bi, int bj, const int32_t *buffer) const { return Transfer(bi, bj, (char *)buffer, true); }
+
+     // Asks the kernel to start reading the tiles ahead of time.
+     void Prefetch(int bi, int bj, int count = 1) const {
+         posix_fadvise(fd_, Offset(bi, bj), (off_t)(tileBytes_ * count), POSIX_FADV_WILLNEED);
+     }
+
+ private:
+     string path_;
+     int fd_, tileSize_, tiles_;
+     size_t tileBytes_;
+
+     off_t Offset(int bi, int bj) const { return (off_t)(((size_t)bi * tiles_ + bj) * tileBytes_); }
+
+     bool Transfer(int bi, int bj, char *buffer, bool write) const {
+         size_t done = 0;
+         while (done < tileBytes_) {
+             ssize_t r = write ? pwrite(fd_, buffer + done, tileBytes_ - done, Offset(bi, bj) + done)
+                               : pread(fd_, buffer + done, tileBytes_ - done, Offset(bi, bj) + done);
+             if (r <= 0) return false;
+             done += (size_t)r;
+         }
+         return true;
+     }
+ };
+
+ // Largest tile size (a multiple of MATRIX_TILE) whose block row, block column and three buffers fit the budget.
+ int TileSizeForBudget(int n, size_t ramBudgetBytes) {
+     int best = MATRIX_TILE;
+     for (int t = MATRIX_TILE; t <= (n + MATRIX_TILE - 1) / MATRIX_TILE * MATRIX_TILE; t += MATRIX_TILE) {
+         size_t padded = (size_t)(n + t - 1) / t * t;
+         size_t bytes = (2 * padded * t + 3 * (size_t)t * t) * sizeof(int32_t);
+         if (bytes > ramBudgetBytes) break;
+         best = t;
+     }
+     return best;
+ }
+
+ /* Blocked Floyd-Warshall over a TileFile. Round kb: close the pivot tile, update the pivot block row and column
+  * through it, write them back, then stream every other tile through memory once: tile(i, j) =
+  * min(tile(i, j), column(i) (x) row(j)). The tiles of the next round's pivot band are streamed first; once they
+  * are written, their read-ahead is requested, so it overlaps the rest of this round's stream instead of the
+  * next round waiting on synchronous reads. Each round is a pass and each tile product T^3 relaxations; the
+  * kernels do not report improvements. Returns false on an I/O error.
+  */
+ template<bool CollectStats>
+ bool ExternalFloydWarshall(TileFile &file, int threads, EngineStats<CollectStats> &stats) {
+     int nb = file.Tiles(), T = file.TileSize();
+     size_t elems = file.TileElements();
+     vector<int32_t> rowBand(elems * nb), colBand(elems * nb), buffers(elems * 3);
+     auto tileView = [&](int32_t *data) { return MatrixView{data, T, T, (size_t)T}; };
+
+     // The pivot block row is contiguous in the file, the pivot block column is one tile per block row.
+     auto prefetchBand = [&](int k) {
+         file.Prefetch(k, 0, nb);
+         for (int i = 0; i < nb; ++i)
+             if (i != k) file.Prefetch(i, k);
+     };
+
+     const ll tileRelaxations = (ll)T * T * T;
+     for (int kb = 0; kb < nb; ++kb) {
+         stats.Pass();
+         for (int j = 0; j < nb; ++j)
+             if (!file.Read(kb, j, &rowBand[elems * j])) return false;
+         for (int i = 0; i < nb; ++i)
+             if (i != kb && !file.Read(i, kb, &colBand[elems * i])) return false;
+
+         MatrixView pivot = tileView(&rowBand[elems * kb]);
+         FloydWarshallBlock(pivot);
+         stats.Relax(tileRelaxations);
+         for (int x = 0; x < nb; ++x) {
+             if (x == kb) continue;
+             MatrixView row = tileView(&rowBand[elems * x]), col = tileView(&colBand[elems * x]);
+             MinPlusMultiplyAdd(row, pivot, row, threads);
+             MinPlusMultiplyAdd(col, col, pivot, threads);
+             stats.Relax(2 * tileRelaxations);
+         }
+         for (int x = 0; x < nb; ++x) {
+             if (!file.Write(kb, x, &rowBand[elems * x])) return false;
+             if (x != kb && !file.Write(x, kb, &colBand[elems * x])) return false;
+         }
+
+         // Tiles in block row or column kb + 1 first: their values are final for the next round once written.
+         int nextPivot = kb + 1;
+         vector<pair<int,int>> work;
+         for (int pass = 0; pass < 2; ++pass)
+             for (int i = 0; i < nb; ++i)
+                 for (int j = 0; j < nb; ++j)
+                     if (i != kb && j != kb && ((i == nextPivot || j == nextPivot) == (pass == 0)))
+                         work.emplace_back(i, j);
+         size_t bandTiles = 0;
+         while (bandTiles < work.size() &&
+                (work[bandTiles].first == nextPivot || work[bandTiles].second == nextPivot)) ++bandTiles;
+         bool prefetched = nextPivot >= nb;
+
+         // Three rotating buffers: tile t+1 is read and tile t-1 written while tile t is being updated.
+         future<bool> reading, writing;
+         if (!work.empty())
+             reading = async(launch::async, [&] { return file.Read(work[0].first, work[0].second, &buffers[0]); });
+         for (size_t t = 0; t < work.size(); ++t) {
+             int32_t *current = &buffers[elems * (t % 3)];
+             if (!reading.get()) return false;
+             if (t + 1 < work.size()) {
+                 auto [ni, nj] = work[t + 1];
+                 int32_t *next = &buffers[elems * ((t + 1) % 3)];
+                 reading = async(launch::async, [&file, ni = ni, nj = nj, next] { return file.Read(ni, nj, next); });
+             }
+             auto [i, j] = work[t];
+             MinPlusMultiplyAdd(tileView(current), tileView(&colBand[elems * i]), tileView(&rowBand[elems * j]),
+                                threads);
+             stats.Relax(tileRelaxations);
+             if (writing.valid() && !writing.get()) return false;
+             // Tile t - 1 is on disk now; if it was the last of the next pivot band, the whole band is.
+             if (!prefetched && t == bandTiles) {
+                 prefetchBand(nextPivot);
+                 prefetched = true;
+             }
+             writing = async(launch::async, [&file, i = i, j = j, current] { return file.Write(i, j, current); });
+         }
+         if (writing.valid() && !writing.get()) return false;
+         if (!prefetched) prefetchBand(nextPivot);
+     }
+     return true;
+ }
+
+ // Writes the initial matrix one block row at a time, so even the input never has to fit in RAM as a whole.
+ bool BuildTileFile(TileFile &file, int N, const vector<Edge> &edges) {
+     int nb = file.Tiles(), T = file.TileSize();
+     size_t elems = file.TileElements();
+     CSRGraph g = BuildCSR(nb * T, edges);
+     vector<int32_t> band(elems * nb);
+     for (int bi = 0; bi < nb; ++bi) {
+         fill(band.begin(), band.end(), MATRIX_INF);
+         for (int r = 0; r < T; ++r) {
+             int u = bi * T + r;
+             if (u <= N) band[elems * (u / T) + (size_t)r * T + u % T] = 0;
+             for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                 int v = g.targets[e];
+                 int32_t &cell = band[elems * (v / T) + (size_t)r * T + v % T];
+                 cell = min<int32_t>(cell, (int32_t)g.weights[e]);
+             }
+         }
+         for (int bj = 0; bj < nb; ++bj)
+             if (!file.Write(bi, bj, &band[elems * bj])) return false;
+     }
+     return true;
+ }
+
+ /* Copies the finished tile file into the APSP result format, one block row of tiles in memory at a time.
+  * Row 0 is saved as unreachable, as in the in-memory mode and Johnson, which only compute nodes 1..N.
+  */
+ bool ExportTiles(const TileFile &file, int N, const string &resultPath) {
+     int nb = file.Tiles(), T = file.TileSize();
+     size_t elems = file.TileElements();
+     APSPWriter writer;
+     if (!writer.Open(resultPath, N + 1, 4)) return false;
+     vector<int32_t> band(elems * nb), row((size_t)nb * T);
+     for (int bi = 0; bi < nb && bi * T <= N; ++bi) {
+         for (int bj = 0; bj < nb; ++bj)
+             if (!file.Read(bi, bj, &band[elems * bj])) return false;
+         for (int r = 0; r < T && bi * T + r <= N; ++r) {
+             for (int bj = 0; bj < nb; ++bj)
+                 copy_n(&band[elems * bj + (size_t)r * T], T, &row[(size_t)bj * T]);
+             if (bi == 0 && r == 0) fill(row.begin(), row.end(), MATRIX_INF);
+             if (!writer.AppendRow(row.data(), MATRIX_INF / 2 + 1)) return false;
          }
      }
+     return writer.Close();
+ }
+
+ template<bool CollectStats>
+ int RunExternalMemory(const string &filePath, const string &tileFilePath, size_t ramBudgetBytes, int threads,
+                       const string &resultPath, EngineStats<CollectStats> &stats) {
+     int N;
+     vector<Edge> edges;
+     if (!LoadEdgeList(filePath, N, edges)) {
+         cout << "Error: could not read " << filePath << '\n';
+         return 1;
+     }
+     ll maxWeight = 0;
+     for (const Edge &e : edges) maxWeight = max(maxWeight, e.weight < 0 ? -e.weight : e.weight);
+     if (maxWeight * (ll)N >= MATRIX_INF / 2) {
+         cout << "Error: distances may not fit in the int32 tile format.\n";
+         return 1;
+     }
+
+     int T = TileSizeForBudget(N + 1, ramBudgetBytes);
+     int padded = (N + 1 + T - 1) / T * T;
+     TileFile file(tileFilePath, padded, T);
+     if (!file.IsOpen() || !BuildTileFile(file, N, edges)) {
+         cout << "Error: could not create " << tileFilePath << '\n';
+         return 1;
+     }
+     edges.clear();
+     edges.shrink_to_fit();
+     cout << "Tile size = " << T << ", tiles per side = " << file.Tiles() << '\n';
+
+     if (!ExternalFloydWarshall(file, threads, stats)) {
+         cout << "Error: I/O failure on " << tileFilePath << '\n';
+         return 1;
+     }
+
+     vector<int32_t> tile(file.TileElements());
+     for (int i = 0; i <= N; ++i) {
+         if (i % T == 0 && !file.Read(i / T, i / T, tile.data())) return 1;
+         if (tile[(size_t)(i % T) * T + i % T] < 0) {
+             cout << "Warning: negative weight cycle detected.\n";
+             return 1;
+         }
+     }
+     if (!resultPath.empty() && !ExportTiles(file, N, resultPath)) {
+         cout << "Error: could not write " << resultPath << '\n';
+         return 1;
+     }
+
+    //  for (int j = 1; j <= N; ++j) {
+    //      if (j == 1 || j % T == 0) file.Read(1 / T, j / T, tile.data());
+    //      int32_t d = tile[(size_t)(1 % T) * T + j % T];
+    //      if (d > MATRIX_INF / 2) cout << "INF";
+    //      else cout << d;
+    //      if (j < N) cout << ' ';
+    //  }
+    //  cout << '\n';
+     return 0;
  }
  
- int main() {
+ /* Floyd–Warshall that also maintains next-hops, so that every shortest path can be reconstructed afterwards.
+  * Prints the memory overhead of the next-hop matrix and a sample path from node 1 to the last node it reaches.
+  * Counts its work in stats like the plain loop in main().
+  */
+ template<typename IndexT, bool CollectStats>
+ void FloydWarshallWithPaths(vector<vector<ll>> &dist, int N, EngineStats<CollectStats> &stats) {
+     NextHopMatrix<IndexT> next(N+1);
+     for (int i = 1; i <= N; ++i)
+         for (int j = 1; j <= N; ++j)
+             if (i != j && dist[i][j] != INF) next.SetEdge(i, j);
+
+     for (int k = 1; k <= N; ++k) {
+         stats.Pass();
+         for (int i = 1; i <= N; ++i) {
+             if (dist[i][k] == INF) continue;
+             for (int j = 1; j <= N; ++j) {
+                 stats.Relax();
+                 if (dist[k][j] != INF && dist[i][k] + dist[k][j] < dist[i][j]) {
+                     dist[i][j] = dist[i][k] + dist[k][j];
+                     next.Relax(i, j, k);
+                     stats.Improve();
+                 }
+             }
+         }
+     }
+
+     size_t distBytes = (size_t)(N+1) * (N+1) * sizeof(ll);
+     cout << "Next-hop matrix = " << next.Bytes() << " bytes (" << sizeof(IndexT) * 8 << "-bit ids, "
+          << 100.0 * next.Bytes() / distBytes << "% of the distance matrix)\n";
+     int t = N;
+     while (t > 1 && dist[1][t] == INF) --t;
+     vector<int> path = next.Path(1, t);
+     cout << "Path 1 -> " << t << ": " << path.size() - 1 << " edges, length " << dist[1][t] << '\n';
+ }
+
+ int main(int argc, char **argv) {
      ios::sync_with_stdio(false);
      cin.tie(nullptr);
  
@@ -50,7 +347,36 @@
      auto begin = chrono::steady_clock::now();
 
      // Warning: The code works but N10 000 is VERY slow. Try the other tests unless you're prepared to wait a while.
-     string filePath = "graph_N10000_D0.001000_negfalse_1.in";
+     string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.001000_negfalse_1.in";
+
+     // External-memory mode: the matrix lives in tileFilePath and at most ramBudgetBytes of tiles are kept in RAM.
+     const bool externalMemory = false;
+     const size_t ramBudgetBytes = size_t(1) << 30;
+     const string tileFilePath = "apsp_tiles.bin";
+     const int threads = argc > 2 ? stoi(argv[2]) : 0; // 0 = all hardware threads
+
+     // Save the distance matrix to resultPath (apsp_file.h format) so that APSPLookup can serve it later.
+     const bool saveResult = false;
+     const string resultPath = "apsp_floyd.bin";
+
+     // Set to true (or build with -DENGINE_STATS=1) to count passes and relaxations in every mode; when false
+     // the counters compile away.
+     constexpr bool collectStats = ENGINE_STATS_ENABLED;
+     EngineStats<collectStats> stats;
+
+     if (externalMemory) {
+         BeginMemoryPhase("external-memory Floyd-Warshall");
+         int status = RunExternalMemory(filePath, tileFilePath, ramBudgetBytes, threads, saveResult ? resultPath : "",
+                                        stats);
+         auto end = chrono::steady_clock::now();
+         cout << "\nMemory usage after algorithm:\n";
+         PrintMemoryUsage();
+         PrintMemoryReport();
+         cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+         stats.Print(cout);
+         return status;
+     }
+     BeginMemoryPhase("load graph");
      ifstream fileStream(filePath);
  
      int N;
@@ -62,23 +388,48 @@
  
      // Read edges
      int u, v;
-     ll w;
+     ll w, maxWeight = 0, edgeCount = 0;
      while (fileStream >> u >> v >> w) {
          dist[u][v] = w;
+         ++edgeCount;
+         maxWeight = max(maxWeight, w < 0 ? -w : w);
      }
  
+     BeginMemoryPhase("Floyd-Warshall");
+     // Path reconstruction: keep next-hops, 16-bit while the vertex ids fit and 32-bit otherwise.
+     const bool trackPaths = false;
+     if (trackPaths) {
+         if (NextHopMatrix<uint16_t>::Fits(N+1)) FloydWarshallWithPaths<uint16_t>(dist, N, stats);
+         else FloydWarshallWithPaths<uint32_t>(dist, N, stats);
+     }
+
      // Floyd–Warshall algorithm
-     for (int k = 1; k <= N; ++k) {
+     for (int k = 1; k <= N && !trackPaths; ++k) {
+         stats.Pass();
          for (int i = 1; i <= N; ++i) {
              if (dist[i][k] == INF) continue;
              for (int j = 1; j <= N; ++j) {
+                 stats.Relax();
                  if (dist[k][j] != INF && dist[i][k] + dist[k][j] < dist[i][j]) {
                      dist[i][j] = dist[i][k] + dist[k][j];
+                     stats.Improve();
                  }
              }
          }
      }
  
+     EndMemoryPhase();
+     TrackStructure("distance matrix", NestedVectorBytes(dist));
+
+     if (saveResult) {
+         APSPWriter writer;
+         bool ok = writer.Open(resultPath, N+1, APSPElementBytes(maxWeight, N+1));
+         // Row 0 holds node 0's raw edges, but the loops above only compute nodes 1..N.
+         vector<ll> none(N+1, INF);
+         for (int i = 0; i <= N && ok; ++i) ok = writer.AppendRow(i == 0 ? none.data() : dist[i].data(), INF);
+         if (!writer.Close() || !ok) cout << "Error: could not write " << resultPath << '\n';
+     }
+
     //  for (int j = 1; j <= N; ++j) {
     //      if (dist[1][j] == INF) cout << "INF";
     //      else cout << dist[1][j];
@@ -89,7 +440,12 @@
      auto end = chrono::steady_clock::now();
      cout << "\nMemory usage after algorithm:\n";
      PrintMemoryUsage();
+     PrintMemoryReport();
      cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+     stats.Print(cout);
+     WriteBenchRecord({"Floyd-Warshall", filePath, N, edgeCount, 1,
+                       chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                       stats.Counters({{"track_paths", (double)trackPaths}})});
  
      return 0;
  }
\ No newline at end of file
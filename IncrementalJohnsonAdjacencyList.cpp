@@ -0,0 +1,204 @@
+/* [Description]
+ * This program runs Johnson's algorithm repeatedly on a graph with negative weights that changes between runs.
+ * The potentials from the previous run are kept and repaired after every update (see johnson_potentials.h),
+ * so only the first run pays for Bellman-Ford; later runs go straight to the N Dijkstra searches.
+ * The test graphs list every edge from the lower to the higher label, so Bellman-Ford over them in file order
+ * converges in one pass; the vertices are therefore relabeled randomly first, as in a graph from any other source.
+ * Every round applies a random batch of insertions, deletions and weight changes, some of them negative. A few
+ * insertions go against the edge direction of the input and can close a negative cycle; the repair then falls
+ * back to Bellman-Ford, and the program rolls the update back (timed separately). After each round the repaired
+ * potentials are checked for feasibility, the time of the repair is compared with a Bellman-Ford from scratch on
+ * the same graph, and one row of the Johnson result is checked against the Bellman-Ford potentials.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, random, algorithm, string: Potentials, relabeling, update generation and file path handling.
+ * - graph_csr.h, dynamic_graph.h: Fast loader and the mutable graph store.
+ * - search_workspace.h, johnson_potentials.h: Dijkstra workspace, potentials and their repair.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <string>
+#include "graph_csr.h"
+#include "dynamic_graph.h"
+#include "search_workspace.h"
+#include "johnson_potentials.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+const ll INF = SearchWorkspace::INF;
+
+bool Feasible(const DynamicGraph &g, const vector<ll> &h) {
+    bool ok = true;
+    for (int u = 0; u < g.VertexCount(); ++u)
+        g.ForEachNeighbor(u, [&](int v, ll w) { ok &= (w + h[u] - h[v] >= 0); });
+    return ok;
+}
+
+// One Johnson run: a Dijkstra per source on the reduced costs. Returns a checksum of all finite distances.
+ll JohnsonRun(const DynamicGraph &g, const vector<ll> &h, int N, SearchWorkspace &ws) {
+    ReducedGraph<DynamicGraph> reduced{g, h};
+    ll checksum = 0;
+    for (int s = 1; s <= N; ++s) {
+        Dijkstra(reduced, s, ws);
+        for (int t = 1; t <= N; ++t) {
+            ll dt = ws.Dist(t);
+            if (dt < INF) checksum += dt - h[s] + h[t];
+        }
+    }
+    return checksum;
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    auto begin = chrono::steady_clock::now();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N1000_D0.100000_negtrue_1.in";
+    const int rounds = 3, updatesPerRound = 500;
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+    vector<int> label(N+1), original(N+1);
+    mt19937 rng(2025);
+    for (int x = 0; x <= N; ++x) label[x] = x;
+    shuffle(label.begin(), label.end(), rng);
+    for (int x = 0; x <= N; ++x) original[label[x]] = x;
+    for (Edge &e : edges) {
+        e.from = label[e.from];
+        e.to = label[e.to];
+    }
+    DynamicGraph g(N+1, edges);
+
+    // The first run computes the potentials from scratch, as JohnsonAdjacencyList.cpp does.
+    BeginMemoryPhase("initial potentials");
+    vector<ll> h;
+    auto bfBegin = chrono::steady_clock::now();
+    if (!BellmanFordPotentials(g, h)) {
+        cout << "Warning: negative weight cycle detected.\n";
+        return 1;
+    }
+    auto bfEnd = chrono::steady_clock::now();
+    cout << "Initial Bellman-Ford: " << chrono::duration_cast<chrono::nanoseconds>(bfEnd - bfBegin).count() << " ns\n";
+
+    BeginMemoryPhase("update rounds");
+    SearchWorkspace ws(N+1);
+    PotentialRepair repair(N+1);
+    uniform_int_distribution<int> pickVertex(0, N), pickWeight(-10, 10), pickKind(0, 3), pickBackward(0, 49);
+    vector<pair<int, ll>> row;
+
+    for (int round = 1; round <= rounds; ++round) {
+        ll repairNs = 0, rejectNs = 0, touched = 0;
+        int rejected = 0;
+        for (int i = 0; i < updatesPerRound; ++i) {
+            int kind = pickKind(rng), x = pickVertex(rng), y;
+            ll w, old = 0;
+            bool existed;
+            row.clear();
+            g.ForEachNeighbor(x, [&](int v, ll wv) { row.emplace_back(v, wv); });
+            if (kind == 3 || row.empty()) {
+                // Insertion; one in fifty goes against the direction of the input edges.
+                y = pickVertex(rng);
+                if (y == x) continue;
+                w = pickWeight(rng);
+                if ((original[x] > original[y]) != (pickBackward(rng) == 0)) swap(x, y);
+                existed = g.SetEdge(x, y, w, &old);
+            } else {
+                tie(y, old) = row[rng() % row.size()];
+                existed = true;
+                if (kind == 0) {
+                    g.RemoveEdge(x, y);
+                    continue;
+                }
+                w = kind == 1 ? old + 5 : old - 5;
+                g.SetEdge(x, y, w);
+            }
+            if (existed && w >= old) continue;
+
+            auto repairBegin = chrono::steady_clock::now();
+            bool ok = repair.Repair(g, h, {{x, y, w}});
+            if (!ok) {
+                // The update closed a negative cycle: undo it and recompute the potentials.
+                if (existed) g.SetEdge(x, y, old);
+                else g.RemoveEdge(x, y);
+                BellmanFordPotentials(g, h);
+                ++rejected;
+            }
+            auto repairEnd = chrono::steady_clock::now();
+            (ok ? repairNs : rejectNs) += chrono::duration_cast<chrono::nanoseconds>(repairEnd - repairBegin).count();
+            touched += repair.LastTouched();
+        }
+
+        vector<ll> fresh;
+        bfBegin = chrono::steady_clock::now();
+        BellmanFordPotentials(g, fresh);
+        bfEnd = chrono::steady_clock::now();
+        if (!Feasible(g, h)) {
+            cout << "Error: repaired potentials are not feasible.\n";
+            return 1;
+        }
+
+        auto runBegin = chrono::steady_clock::now();
+        ll checksum = JohnsonRun(g, h, N, ws);
+        auto runEnd = chrono::steady_clock::now();
+
+        ReducedGraph<DynamicGraph> check{g, fresh};
+        Dijkstra(check, 1, ws);
+        vector<ll> expected(N+1);
+        for (int t = 1; t <= N; ++t) expected[t] = ws.Dist(t) < INF ? ws.Dist(t) - fresh[1] + fresh[t] : INF;
+        ReducedGraph<DynamicGraph> reduced{g, h};
+        Dijkstra(reduced, 1, ws);
+        for (int t = 1; t <= N; ++t) {
+            ll dt = ws.Dist(t) < INF ? ws.Dist(t) - h[1] + h[t] : INF;
+            if (dt != expected[t]) {
+                cout << "Error: distance 1 -> " << t << " differs from the Bellman-Ford potentials.\n";
+                return 1;
+            }
+        }
+
+        cout << "Round " << round << ": potential repair = " << repairNs << " ns (" << touched
+             << " vertices touched), " << rejected << " rejected updates = " << rejectNs
+             << " ns, Bellman-Ford from scratch = "
+             << chrono::duration_cast<chrono::nanoseconds>(bfEnd - bfBegin).count() << " ns, Dijkstra phase = "
+             << chrono::duration_cast<chrono::nanoseconds>(runEnd - runBegin).count() << " ns, checksum "
+             << checksum << '\n';
+    }
+    cout << "Bellman-Ford fallbacks = " << repair.Fallbacks() << '\n';
+    EndMemoryPhase();
+    TrackStructure("dynamic graph", (ll)g.Bytes());
+    TrackStructure("potentials", VectorBytes(h));
+    TrackStructure("search workspace", (ll)ws.Bytes());
+
+    auto end = chrono::steady_clock::now();
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    WriteBenchRecord({"incremental Johnson", filePath, N, (ll)edges.size(), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"rounds", (double)rounds}, {"updates_per_round", (double)updatesPerRound},
+                       {"bellman_ford_fallbacks", (double)repair.Fallbacks()}}});
+
+    return 0;
+}
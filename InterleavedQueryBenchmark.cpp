@@ -0,0 +1,150 @@
+/* [Description]
+ * This program measures how much of the memory latency of point-to-point Dijkstra queries the coroutine
+ * executor of interleaved_queries.h hides. The same batch of random queries is answered
+ * - one after another on the adjacency list, as DijkstraAdjacencyList does (with a reused workspace),
+ * - one after another on the CSR graph,
+ * - interleaved on the CSR graph with 1, 2, 4, ... lanes (independent searches on one thread),
+ * and the queries per second of each are printed with the speedup over the sequential CSR run. The answers of
+ * every run must be identical. On graphs that fit in the cache there is no latency to hide and the suspensions
+ * are pure overhead; the measurements in interleaved_queries.h show no gain on larger graphs either.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Usage: ./InterleavedQueryBenchmark [graph file] [queries = 1000] [max lanes = 32]
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, string, random: Graph, queries and file path handling.
+ * - graph_csr.h: Fast loader and CSR graph.
+ * - search_workspace.h: Sequential multi-query API.
+ * - interleaved_queries.h: The coroutine batch executor.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+#include "graph_csr.h"
+#include "search_workspace.h"
+#include "interleaved_queries.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+
+ll ElapsedNs(chrono::steady_clock::time_point from) {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - from).count();
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    auto begin = chrono::steady_clock::now();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.001000_negfalse_1.in";
+    int queryCount = argc > 2 ? stoi(argv[2]) : 1000;
+    int maxLanes = argc > 3 ? stoi(argv[3]) : 32;
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+    CSRGraph csr = BuildCSR(N+1, edges);
+    AdjacencyList adj(N+1);
+    for (const Edge &e : edges) {
+        if (e.weight < 0) {
+            cout << "Error: Dijkstra needs non-negative weights.\n";
+            return 1;
+        }
+        adj[e.from].emplace_back(e.to, e.weight);
+    }
+
+    mt19937 rng(12345);
+    uniform_int_distribution<int> pick(1, N);
+    vector<pair<int,int>> queries(queryCount);
+    for (auto &q : queries) q = {pick(rng), pick(rng)};
+
+    BeginMemoryPhase("sequential");
+    SearchWorkspace ws(N+1);
+    vector<ll> expected, answers;
+    auto start = chrono::steady_clock::now();
+    DistanceQueries(adj, queries, ws, expected);
+    ll adjacencyNs = ElapsedNs(start);
+    start = chrono::steady_clock::now();
+    DistanceQueries(csr, queries, ws, answers);
+    ll csrNs = ElapsedNs(start);
+    if (answers != expected) {
+        cout << "Error: CSR answers differ from the adjacency list.\n";
+        return 1;
+    }
+
+    cout.setf(ios::fixed);
+    cout.precision(1);
+    cout << "Queries = " << queryCount << '\n';
+    cout << "Sequential, adjacency list: " << queryCount * 1e9 / adjacencyNs << " queries/s\n";
+    cout << "Sequential, CSR:            " << queryCount * 1e9 / csrNs << " queries/s\n";
+
+    BeginMemoryPhase("interleaved");
+    vector<SearchWorkspace> workspaces;
+    int bestLanes = 0;
+    ll bestNs = 0;
+    for (int lanes = 1; lanes <= maxLanes; lanes *= 2) {
+        while ((int)workspaces.size() < lanes) workspaces.emplace_back(N+1);
+        start = chrono::steady_clock::now();
+        InterleavedDistanceQueries(csr, queries, workspaces, answers);
+        ll ns = ElapsedNs(start);
+        if (answers != expected) {
+            cout << "Error: interleaved answers with " << lanes << " lanes differ from the sequential ones.\n";
+            return 1;
+        }
+        cout << "Interleaved, " << lanes << (lanes < 10 ? " lanes:  " : " lanes: ") << queryCount * 1e9 / ns
+             << " queries/s (" << (double)csrNs / ns << "x sequential CSR)\n";
+        if (!bestLanes || ns < bestNs) {
+            bestLanes = lanes;
+            bestNs = ns;
+        }
+    }
+    EndMemoryPhase();
+    cout.unsetf(ios::fixed);
+    cout.precision(6);
+
+    TrackStructure("adjacency list", NestedVectorBytes(adj));
+    TrackStructure("CSR graph", (ll)csr.Bytes());
+    TrackStructure("workspace per lane", (ll)ws.Bytes());
+
+    /*
+    for (size_t i = 0; i < queries.size(); ++i) {
+        cout << queries[i].first << " -> " << queries[i].second << ": ";
+        if (expected[i] == SearchWorkspace::INF) cout << "INF\n";
+        else cout << expected[i] << '\n';
+    }
+    */
+
+    auto end = chrono::steady_clock::now();
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    WriteBenchRecord({"interleaved Dijkstra", filePath, N, (long long)edges.size(), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"queries", (double)queryCount},
+                       {"sequential_adjacency_qps", queryCount * 1e9 / adjacencyNs},
+                       {"sequential_csr_qps", queryCount * 1e9 / csrNs},
+                       {"best_lanes", (double)bestLanes},
+                       {"best_interleaved_qps", queryCount * 1e9 / bestNs}}});
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+/* [Description]
+ * This program computes all-pairs shortest paths with two engines from min_plus.h and compares them:
+ * repeated squaring of the distance matrix in the (min,+) semiring, which needs only O(log H) products for
+ * graphs whose shortest paths have at most H edges, and the blocked Floyd-Warshall built on the same
+ * min-plus kernel. Both results are checked against each other.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, string: Edge list and file path handling.
+ * - graph_csr.h: Fast edge-list loader.
+ * - min_plus.h: DistanceMatrix, min-plus product, squaring APSP and blocked Floyd-Warshall.
+ * - numa_alloc.h: Huge-page / NUMA options for the matrices (GRAPH_MEMORY).
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include "graph_csr.h"
+#include "min_plus.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    // GRAPH_MEMORY=huge,interleave (numa_alloc.h) switches the matrices to huge pages / interleaved nodes.
+    const MemoryOptions &memory = GlobalMemoryOptions();
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N1000_D0.100000_negfalse_1.in";
+    const int threads = argc > 2 ? stoi(argv[2]) : 0; // 0 = all hardware threads
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+
+    DistanceMatrix weights(N + 1);
+    for (const Edge &e : edges) {
+        weights.at(e.from, e.to) = min<int32_t>(weights.at(e.from, e.to), (int32_t)e.weight);
+    }
+
+    BeginMemoryPhase("repeated squaring");
+    DistanceMatrix squared = weights;
+    auto begin = chrono::steady_clock::now();
+    int rounds = SquaringAPSP(squared, threads);
+    auto mid = chrono::steady_clock::now();
+
+    BeginMemoryPhase("blocked Floyd-Warshall");
+    DistanceMatrix blocked = weights;
+    BlockedFloydWarshall(blocked, 256, threads);
+    auto end = chrono::steady_clock::now();
+    EndMemoryPhase();
+    TrackStructure("edge list", VectorBytes(edges));
+    TrackStructure("distance matrix (each of 3)", (long long)weights.Bytes());
+
+    if (rounds < 0 || HasNegativeCycle(blocked)) {
+        cout << "Warning: negative weight cycle detected.\n";
+        return 1;
+    }
+    if (!(squared == blocked)) {
+        cout << "Error: repeated squaring and blocked Floyd-Warshall disagree.\n";
+        return 1;
+    }
+
+    // for (int j = 1; j <= N; ++j) {
+    //     if (blocked.at(1, j) == MATRIX_INF) cout << "INF";
+    //     else cout << blocked.at(1, j);
+    //     if (j < N) cout << ' ';
+    // }
+    // cout << '\n';
+
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Repeated squaring (" << rounds << " products) = "
+         << chrono::duration_cast<chrono::nanoseconds>(mid - begin).count() << " ns\n";
+    cout << "Blocked Floyd-Warshall = " << chrono::duration_cast<chrono::nanoseconds>(end - mid).count() << " ns\n";
+    cout << "Memory: " << DescribeMemoryOptions(memory) << '\n';
+    WriteBenchRecord({"repeated squaring", filePath, N, (long long)edges.size(), threads,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"squaring_ns", (double)chrono::duration_cast<chrono::nanoseconds>(mid - begin).count()},
+                       {"blocked_floyd_warshall_ns",
+                        (double)chrono::duration_cast<chrono::nanoseconds>(end - mid).count()},
+                       {"products", (double)rounds}}});
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/* [Description]
+ * This program answers a batch of point-to-point and distance-table queries against one graph using the
+ * multi-query API from search_workspace.h. All queries share a single SearchWorkspace, so starting a query
+ * costs O(1) instead of re-filling the distance array and building a new priority queue.
+ * For comparison, the same point-to-point queries are also answered the straightforward way (fresh
+ * arrays and priority_queue per query) and both timings are printed.
+ * Every heap allocation is counted (memory_stats.h). The batches are finally repeated on a workspace whose
+ * storage comes from a QueryArena (query_arena.h); after one warmup batch they must make no allocations.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - fstream: For reading input graph files.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, queue: Adjacency list and the per-query priority_queue of the baseline.
+ * - random: For generating the query batch.
+ * - string: For file path handling.
+ * - search_workspace.h: SearchWorkspace and the multi-query API.
+ * - query_arena.h: Arena for the workspace's storage.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <queue>
+#include <random>
+#include <string>
+#include "search_workspace.h"
+#include "query_arena.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+const ll INF = SearchWorkspace::INF;
+
+// Baseline: what each single-query program does, allocating and initializing O(N) state per query.
+ll FreshDijkstra(const AdjacencyList &adj, int s, int t) {
+    vector<ll> d(adj.size(), INF);
+    vector<bool> visited(adj.size(), false);
+    priority_queue<pair<ll,int>, vector<pair<ll,int>>, greater<pair<ll,int>>> pq;
+    d[s] = 0;
+    pq.emplace(0, s);
+    while (!pq.empty()) {
+        auto [du, x] = pq.top(); pq.pop();
+        if (visited[x]) continue;
+        visited[x] = true;
+        if (x == t) break;
+        for (auto [y, w] : adj[x]) {
+            if (du + w < d[y]) {
+                d[y] = du + w;
+                pq.emplace(d[y], y);
+            }
+        }
+    }
+    return d[t];
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
+    const int queryCount = 1000;
+    const int tableSize = 32;
+
+    BeginMemoryPhase("load graph");
+    ifstream fileStream(filePath);
+    int N;
+    fileStream >> N;
+
+    AdjacencyList adj(N+1);
+    int u, v;
+    ll w;
+    while (fileStream >> u >> v >> w) {
+        adj[u].emplace_back(v, w);
+    }
+
+    mt19937 rng(12345);
+    uniform_int_distribution<int> pick(1, N);
+    vector<pair<int,int>> queries(queryCount);
+    for (auto &q : queries) q = {pick(rng), pick(rng)};
+
+    BeginMemoryPhase("fresh state per query");
+    AllocationSnapshot start = AllocationCounts();
+    auto begin = chrono::steady_clock::now();
+    vector<ll> fresh;
+    fresh.reserve(queryCount);
+    for (auto [s, t] : queries) fresh.push_back(FreshDijkstra(adj, s, t));
+    auto mid = chrono::steady_clock::now();
+    AllocationSnapshot freshAllocs = AllocationCounts() - start;
+
+    BeginMemoryPhase("reused workspace");
+    start = AllocationCounts();
+    SearchWorkspace ws(N+1);
+    vector<ll> answers = DistanceQueries(adj, queries, ws);
+    auto end = chrono::steady_clock::now();
+    AllocationSnapshot reusedAllocs = AllocationCounts() - start;
+
+    if (answers != fresh) {
+        cout << "Error: workspace answers differ from the baseline.\n";
+        return 1;
+    }
+
+    vector<int> sources, targets;
+    for (int i = 0; i < tableSize; ++i) {
+        sources.push_back(pick(rng));
+        targets.push_back(pick(rng));
+    }
+    auto tableBegin = chrono::steady_clock::now();
+    vector<ll> table = DistanceTable(adj, sources, targets, ws);
+    auto tableEnd = chrono::steady_clock::now();
+
+    // The same batches on arena storage: one warmup round grows everything to its working size, the timed
+    // round must then run without a single heap allocation.
+    BeginMemoryPhase("arena workspace");
+    size_t edgeCount = 0;
+    for (auto &list : adj) edgeCount += list.size();
+    QueryArena arena(QueryArena::WorkspaceBytes(N+1, N+1));
+    SearchWorkspace arenaWs(N+1, arena.Resource());
+    vector<ll> arenaAnswers, arenaTable;
+    DistanceQueries(adj, queries, arenaWs, arenaAnswers);
+    DistanceTable(adj, sources, targets, arenaWs, arenaTable);
+    start = AllocationCounts();
+    auto arenaBegin = chrono::steady_clock::now();
+    DistanceQueries(adj, queries, arenaWs, arenaAnswers);
+    DistanceTable(adj, sources, targets, arenaWs, arenaTable);
+    auto arenaEnd = chrono::steady_clock::now();
+    AllocationSnapshot arenaAllocs = AllocationCounts() - start;
+    EndMemoryPhase();
+    TrackStructure("adjacency list", NestedVectorBytes(adj));
+    TrackStructure("search workspace", (ll)ws.Bytes());
+    TrackStructure("query arena block", (ll)arena.InitialBytes());
+    if (arenaAnswers != answers || arenaTable != table) {
+        cout << "Error: arena answers differ from the workspace answers.\n";
+        return 1;
+    }
+
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Point-to-point queries = " << queryCount << '\n';
+    cout << "Fresh state per query = " << chrono::duration_cast<chrono::nanoseconds>(mid - begin).count() << " ns\n";
+    cout << "Reused workspace = " << chrono::duration_cast<chrono::nanoseconds>(end - mid).count() << " ns\n";
+    cout << "Distance table " << tableSize << "x" << tableSize << " = "
+         << chrono::duration_cast<chrono::nanoseconds>(tableEnd - tableBegin).count() << " ns\n";
+    cout << "Arena workspace, queries + table after warmup = "
+         << chrono::duration_cast<chrono::nanoseconds>(arenaEnd - arenaBegin).count() << " ns\n";
+    cout << "Heap allocations: fresh state " << freshAllocs.allocations << " (" << freshAllocs.bytes << " bytes), "
+         << "reused workspace " << reusedAllocs.allocations << " (" << reusedAllocs.bytes << " bytes), "
+         << "arena after warmup " << arenaAllocs.allocations << " (" << arenaAllocs.bytes << " bytes)\n";
+    WriteBenchRecord({"multi-query Dijkstra", filePath, N, (ll)edgeCount, 1,
+                      chrono::duration_cast<chrono::nanoseconds>(arenaEnd - begin).count(),
+                      {{"queries", (double)queryCount},
+                       {"fresh_ns", (double)chrono::duration_cast<chrono::nanoseconds>(mid - begin).count()},
+                       {"reused_ns", (double)chrono::duration_cast<chrono::nanoseconds>(end - mid).count()},
+                       {"table_ns", (double)chrono::duration_cast<chrono::nanoseconds>(tableEnd - tableBegin).count()},
+                       {"arena_ns", (double)chrono::duration_cast<chrono::nanoseconds>(arenaEnd - arenaBegin).count()},
+                       {"arena_allocations", (double)arenaAllocs.allocations}}});
+
+    return 0;
+}
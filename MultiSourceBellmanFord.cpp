@@ -0,0 +1,260 @@
+/* [Description]
+ * This program computes shortest paths from several sources at once with a batched, queue-based
+ * Bellman-Ford (SPFA-like) engine. The distances of L sources (L = 8 or 16) are stored next to each other
+ * as dist[v][lane], so scanning an edge (u, v, w) once relaxes all L sources with a single vector add and
+ * a vector min (AVX2, 8 x int32 per register). A vertex is put back into the queue when any of its lanes
+ * improves. Negative edge weights are supported and negative cycles are detected.
+ * The batched engine is compared with the per-source loop of JohnsonAdjacencyList.cpp (Bellman-Ford
+ * potentials once, then one Dijkstra per source on the reweighted graph) for the same set of sources,
+ * and the per-source throughput of both is printed.
+ * Important note: Distances are kept in 32-bit lanes, so |weight| * (N - 1) has to stay below 2^30.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, queue: Distance lanes and the processing queue.
+ * - cstdint, limits, string: Lane type, INF definitions and file path handling.
+ * - immintrin.h: AVX2 intrinsics; the AVX2 kernel is selected at runtime, a scalar kernel is used otherwise.
+ * - graph_csr.h, search_workspace.h: Fast loader, CSR graph and the Dijkstra used by the Johnson loop.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <immintrin.h>
+#include "graph_csr.h"
+#include "search_workspace.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+const ll INF = SearchWorkspace::INF;
+const int32_t INF32 = 1 << 30;
+
+/* Relaxes every outgoing edge of u for all L lanes and writes the heads whose distance improved in at
+ * least one lane into 'improved'. Returns the number of improved heads.
+ */
+template<int L>
+int RelaxVertexScalar(const CSRGraph &g, const vector<int32_t> &w32, int u, int32_t *dist, int *improved) {
+    const int32_t *du = dist + (size_t)u * L;
+    int count = 0;
+    for (int i = g.offsets[u]; i < g.offsets[u+1]; ++i) {
+        int32_t *dv = dist + (size_t)g.targets[i] * L;
+        bool any = false;
+        for (int lane = 0; lane < L; ++lane) {
+            if (du[lane] == INF32) continue;
+            int32_t cand = du[lane] + w32[i];
+            if (cand < dv[lane]) {
+                dv[lane] = cand;
+                any = true;
+            }
+        }
+        if (any) improved[count++] = g.targets[i];
+    }
+    return count;
+}
+
+template<int L>
+__attribute__((target("avx2")))
+int RelaxVertexAVX2(const CSRGraph &g, const vector<int32_t> &w32, int u, int32_t *dist, int *improved) {
+    constexpr int R = L / 8;
+    const __m256i inf = _mm256_set1_epi32(INF32);
+    __m256i du[R], unreachable[R];
+    for (int r = 0; r < R; ++r) {
+        du[r] = _mm256_loadu_si256((const __m256i *)(dist + (size_t)u * L + 8 * r));
+        unreachable[r] = _mm256_cmpeq_epi32(du[r], inf);
+    }
+    int count = 0;
+    for (int i = g.offsets[u]; i < g.offsets[u+1]; ++i) {
+        int32_t *dv = dist + (size_t)g.targets[i] * L;
+        const __m256i w = _mm256_set1_epi32(w32[i]);
+        int changed = 0;
+        for (int r = 0; r < R; ++r) {
+            __m256i old = _mm256_loadu_si256((const __m256i *)(dv + 8 * r));
+            // Lanes where u is still unreachable must not produce INF + w.
+            __m256i cand = _mm256_blendv_epi8(_mm256_add_epi32(du[r], w), inf, unreachable[r]);
+            __m256i best = _mm256_min_epi32(old, cand);
+            changed |= _mm256_movemask_epi8(_mm256_cmpgt_epi32(old, best));
+            _mm256_storeu_si256((__m256i *)(dv + 8 * r), best);
+        }
+        if (changed) improved[count++] = g.targets[i];
+    }
+    return count;
+}
+
+/* Computes dist[v * L + lane] = shortest distance from sources[lane] to v.
+ * Returns false if a negative cycle is reachable from any of the sources.
+ */
+template<int L>
+bool BatchedBellmanFord(const CSRGraph &g, const vector<int32_t> &w32, const int *sources,
+                        vector<int32_t> &dist, bool useAVX2) {
+    int n = g.VertexCount();
+    dist.assign((size_t)n * L, INF32);
+    vector<char> inQueue(n, 0);
+    vector<ll> cnt(n, 0);
+    int maxDegree = 0;
+    for (int u = 0; u < n; ++u) maxDegree = max(maxDegree, g.offsets[u+1] - g.offsets[u]);
+    vector<int> improved(maxDegree);
+
+    queue<int> q;
+    for (int lane = 0; lane < L; ++lane) {
+        dist[(size_t)sources[lane] * L + lane] = 0;
+        if (!inQueue[sources[lane]]) {
+            q.push(sources[lane]);
+            inQueue[sources[lane]] = 1;
+        }
+    }
+
+    while (!q.empty()) {
+        int x = q.front(); q.pop();
+        inQueue[x] = 0;
+        int k = useAVX2 ? RelaxVertexAVX2<L>(g, w32, x, dist.data(), improved.data())
+                        : RelaxVertexScalar<L>(g, w32, x, dist.data(), improved.data());
+        for (int i = 0; i < k; ++i) {
+            int y = improved[i];
+            if (inQueue[y]) continue;
+            q.push(y);
+            inQueue[y] = 1;
+            // Each lane alone may enqueue y at most N times, so L * N bounds the batch.
+            if (++cnt[y] > (ll)L * n) return false;
+        }
+    }
+    return true;
+}
+
+// Runs the batched engine over all sources in groups of L and reports the time spent in it. Only the solver
+// is timed; each batch is checked against the Johnson distances outside the clock.
+template<int L>
+bool RunBatches(const CSRGraph &g, const vector<int32_t> &w32, const vector<int> &sources,
+                const vector<vector<ll>> &expected, bool useAVX2, const string &name) {
+    vector<int32_t> dist;
+    ll ns = 0, mismatches = 0;
+    for (size_t b = 0; b < sources.size(); b += L) {
+        auto begin = chrono::steady_clock::now();
+        bool ok = BatchedBellmanFord<L>(g, w32, &sources[b], dist, useAVX2);
+        ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        if (!ok) {
+            cout << "Warning: negative weight cycle detected.\n";
+            return false;
+        }
+        for (int lane = 0; lane < L; ++lane) {
+            for (int t = 0; t < g.VertexCount(); ++t) {
+                int32_t d = dist[(size_t)t * L + lane];
+                if ((d == INF32 ? INF : d) != expected[b + lane][t]) ++mismatches;
+            }
+        }
+    }
+    cout << name << " = " << ns << " ns, " << ns / (ll)sources.size() << " ns/source";
+    if (mismatches) cout << " (" << mismatches << " distances differ from Johnson!)";
+    cout << '\n';
+    return mismatches == 0;
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.010000_negtrue_1.in";
+    const int sourceCount = 64; // must be a multiple of 16
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+    CSRGraph g = BuildCSR(N + 1, edges);
+
+    ll maxWeight = 0;
+    for (ll w : g.weights) maxWeight = max(maxWeight, w < 0 ? -w : w);
+    if (maxWeight * (ll)N >= INF32) {
+        cout << "Error: weights are too large for 32-bit distance lanes.\n";
+        return 1;
+    }
+    vector<int32_t> w32(g.weights.begin(), g.weights.end());
+
+    vector<int> sources(sourceCount);
+    for (int i = 0; i < sourceCount; ++i) sources[i] = 1 + i % N;
+
+    // Per-source loop of JohnsonAdjacencyList.cpp: potentials once, then Dijkstra per source.
+    BeginMemoryPhase("Johnson per source");
+    auto begin = chrono::steady_clock::now();
+    vector<ll> h(N+1, 0);
+    for (int i = 1; i < N; ++i) {
+        bool updated = false;
+        for (const Edge &e : edges) {
+            if (h[e.from] + e.weight < h[e.to]) {
+                h[e.to] = h[e.from] + e.weight;
+                updated = true;
+            }
+        }
+        if (!updated) break;
+    }
+    for (const Edge &e : edges) {
+        if (h[e.from] + e.weight < h[e.to]) {
+            cout << "Warning: negative weight cycle detected.\n";
+            return 1;
+        }
+    }
+    AdjacencyList adj(N+1);
+    for (const Edge &e : edges) adj[e.from].emplace_back(e.to, e.weight + h[e.from] - h[e.to]);
+    auto potentialsEnd = chrono::steady_clock::now();
+
+    vector<vector<ll>> expected(sourceCount, vector<ll>(N+1, INF));
+    SearchWorkspace ws(N+1);
+    for (int i = 0; i < sourceCount; ++i) {
+        int s = sources[i];
+        Dijkstra(adj, s, ws);
+        for (int t = 0; t <= N; ++t) {
+            ll dt = ws.Dist(t);
+            if (dt < INF) expected[i][t] = dt - h[s] + h[t];
+        }
+    }
+    auto johnsonEnd = chrono::steady_clock::now();
+    ll potentialNs = chrono::duration_cast<chrono::nanoseconds>(potentialsEnd - begin).count();
+    ll dijkstraNs = chrono::duration_cast<chrono::nanoseconds>(johnsonEnd - potentialsEnd).count();
+    cout << "\nSources = " << sourceCount << '\n';
+    cout << "Johnson potentials = " << potentialNs << " ns\n";
+    cout << "Johnson per-source Dijkstra = " << dijkstraNs << " ns, " << dijkstraNs / sourceCount << " ns/source\n";
+
+    TrackStructure("CSR graph", (long long)g.Bytes());
+    TrackStructure("32-bit weights", VectorBytes(w32));
+    TrackStructure("Johnson adjacency list", NestedVectorBytes(adj));
+    TrackStructure("Johnson workspace", (long long)ws.Bytes());
+    TrackStructure("expected distances", NestedVectorBytes(expected));
+
+    BeginMemoryPhase("batched Bellman-Ford");
+    bool hasAVX2 = __builtin_cpu_supports("avx2");
+    bool ok = RunBatches<8>(g, w32, sources, expected, false, "Batched Bellman-Ford, 8 scalar lanes");
+    if (hasAVX2) {
+        ok = ok && RunBatches<8>(g, w32, sources, expected, true, "Batched Bellman-Ford, 8 AVX2 lanes");
+        ok = ok && RunBatches<16>(g, w32, sources, expected, true, "Batched Bellman-Ford, 16 AVX2 lanes");
+    } else {
+        cout << "AVX2 is not available, only the scalar kernel was run.\n";
+    }
+    auto end = chrono::steady_clock::now();
+
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    WriteBenchRecord({"multi-source Bellman-Ford", filePath, N, (ll)edges.size(), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"sources", (double)sourceCount}, {"johnson_potentials_ns", (double)potentialNs},
+                       {"johnson_dijkstra_ns", (double)dijkstraNs}, {"avx2", (double)hasAVX2}}});
+
+    return ok ? 0 : 1;
+}
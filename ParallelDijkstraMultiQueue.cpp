@@ -0,0 +1,210 @@
+/* [Description]
+ * This program contains a parallel Dijkstra from node 1 in which all threads share one MultiQueue
+ * (multi_queue.h): c * p binary heaps with try-locks, popping the better of two random heaps.
+ * Because the queue is relaxed, a thread may settle a vertex before its final distance is known. The search
+ * tolerates this the way label-correcting algorithms do: distances are lowered with an atomic fetch-min, every
+ * improvement pushes the vertex again, and a popped entry whose key is above the current distance is stale and
+ * skipped. A vertex that is popped with a distance that is later improved is simply relaxed again; the
+ * result is exact, only the work grows. The search ends when no entry is queued or being processed (a shared
+ * counter, incremented before every push and decremented after a popped entry has been relaxed).
+ * The program runs the search with 1, 2, 4, ... threads up to the given count and reports, for each:
+ * - the time and the speedup over the sequential binary-heap Dijkstra and over the 1-thread MultiQueue,
+ * - the wasted work: settles beyond one per reachable vertex, stale pops, and relaxations relative to the
+ *   sequential run.
+ * The distances of every run are checked against the sequential Dijkstra.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Usage: ./ParallelDijkstraMultiQueue [graph file] [threads = 0 (all cores)] [heaps per thread c = 2]
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, string, algorithm: Distances, results and file path handling.
+ * - atomic, thread: Shared distances, the pending counter and the worker threads.
+ * - graph_csr.h: Fast loader and CSR graph.
+ * - search_workspace.h: Sequential reference Dijkstra.
+ * - multi_queue.h: The relaxed concurrent priority queue.
+ * - engine_stats.h: Per-thread relaxation and queue counters, merged after the join.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "graph_csr.h"
+#include "search_workspace.h"
+#include "multi_queue.h"
+#include "engine_stats.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+using ll = long long;
+const ll INF = SearchWorkspace::INF;
+
+/* Parallel Dijkstra from source on threads threads sharing a MultiQueue with c heaps per thread. dist must have
+ * VertexCount(g) entries; it is reset here. The counters of all threads are merged into stats.
+ */
+void MultiQueueDijkstra(const CSRGraph &g, int source, int threads, int c, vector<atomic<ll>> &dist,
+                        EngineStats<true> &stats) {
+    for (auto &d : dist) d.store(INF, memory_order_relaxed);
+    MultiQueue<> queue(c * threads);
+    atomic<ll> pending(1);
+    dist[source].store(0, memory_order_relaxed);
+    MultiQueueRng seedRng(source);
+    queue.Push(0, source, seedRng);
+    stats.Push();
+
+    vector<EngineStats<true>> threadStats(threads);
+    auto worker = [&](int index) {
+        EngineStats<true> &counts = threadStats[index];
+        MultiQueueRng rng(index + 1);
+        pair<ll, int> entry;
+        while (true) {
+            if (!queue.TryPop(entry, rng)) {
+                if (pending.load(memory_order_acquire) == 0) return;
+                this_thread::yield();
+                continue;
+            }
+            counts.Pop();
+            auto [du, x] = entry;
+            if (du > dist[x].load(memory_order_relaxed)) {
+                counts.StalePop();
+            } else {
+                for (int i = g.offsets[x]; i < g.offsets[x + 1]; ++i) {
+                    counts.Relax();
+                    int y = g.targets[i];
+                    ll nd = du + g.weights[i];
+                    ll current = dist[y].load(memory_order_relaxed);
+                    while (nd < current && !dist[y].compare_exchange_weak(current, nd, memory_order_relaxed)) {}
+                    if (nd < current) {
+                        counts.Improve();
+                        pending.fetch_add(1, memory_order_relaxed);
+                        queue.Push(nd, y, rng);
+                        counts.Push();
+                    }
+                }
+            }
+            pending.fetch_sub(1, memory_order_acq_rel);
+        }
+    };
+    vector<thread> pool;
+    for (int i = 0; i < threads; ++i) pool.emplace_back(worker, i);
+    for (auto &th : pool) th.join();
+    for (const auto &counts : threadStats) stats.Merge(counts);
+}
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    auto begin = chrono::steady_clock::now();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
+    int maxThreads = argc > 2 ? stoi(argv[2]) : 0;
+    int heapsPerThread = argc > 3 ? max(1, stoi(argv[3])) : 2;
+    if (maxThreads <= 0) maxThreads = max(1u, thread::hardware_concurrency());
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+    for (const Edge &e : edges) {
+        if (e.weight < 0) {
+            cout << "Error: Dijkstra needs non-negative weights.\n";
+            return 1;
+        }
+    }
+    CSRGraph graph = BuildCSR(N+1, edges);
+
+    BeginMemoryPhase("sequential Dijkstra");
+    SearchWorkspace ws(N+1);
+    EngineStats<true> sequentialStats;
+    auto start = chrono::steady_clock::now();
+    QueueDijkstra(graph, 1, ws, ws.Heap(), -1, sequentialStats);
+    ll sequentialNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    ll reachable = 0;
+    for (int v = 1; v <= N; ++v) reachable += ws.Dist(v) < INF;
+
+    cout.setf(ios::fixed);
+    cout.precision(2);
+    cout << "Sequential Dijkstra: " << sequentialNs << " ns, " << reachable << " reachable vertices, "
+         << sequentialStats.relaxations << " relaxations\n";
+
+    BeginMemoryPhase("MultiQueue Dijkstra");
+    vector<atomic<ll>> dist(N+1);
+    ll oneThreadNs = 0, bestNs = 0;
+    int bestThreads = 0;
+    EngineStats<true> bestStats;
+    for (int threads = 1;; threads = min(threads * 2, maxThreads)) {
+        EngineStats<true> stats;
+        start = chrono::steady_clock::now();
+        MultiQueueDijkstra(graph, 1, threads, heapsPerThread, dist, stats);
+        ll ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        for (int v = 1; v <= N; ++v) {
+            if (dist[v].load() != ws.Dist(v)) {
+                cout << "Error: distance of " << v << " with " << threads << " threads differs from Dijkstra.\n";
+                return 1;
+            }
+        }
+        if (threads == 1) oneThreadNs = ns;
+        if (!bestThreads || ns < bestNs) {
+            bestThreads = threads;
+            bestNs = ns;
+            bestStats = stats;
+        }
+        ll settles = stats.pops - stats.stalePops;
+        cout << threads << (threads < 10 ? " threads:  " : " threads: ") << ns << " ns, speedup "
+             << (double)sequentialNs / ns << "x over Dijkstra, " << (double)oneThreadNs / ns
+             << "x over 1 thread; extra settles " << 100.0 * (settles - reachable) / max(1LL, reachable)
+             << "%, stale pops " << stats.stalePops << ", relaxations "
+             << (double)stats.relaxations / max(1LL, sequentialStats.relaxations) << "x Dijkstra\n";
+        if (threads == maxThreads) break;
+    }
+    EndMemoryPhase();
+    cout.unsetf(ios::fixed);
+    cout.precision(6);
+
+    TrackStructure("CSR graph", (ll)graph.Bytes());
+    TrackStructure("atomic distances", (ll)(dist.size() * sizeof(atomic<ll>)));
+    TrackStructure("search workspace (sequential)", (ll)ws.Bytes());
+
+    // for (int i = 1; i <= N; ++i) {
+    //     if (dist[i] == INF) cout << "-1 ";
+    //     else cout << dist[i] << ' ';
+    // }
+    // cout << '\n';
+
+    auto end = chrono::steady_clock::now();
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    cout << "Best: " << bestThreads << " threads, " << heapsPerThread << " heaps per thread\n";
+    bestStats.Print(cout);
+    ll bestSettles = bestStats.pops - bestStats.stalePops;
+    WriteBenchRecord({"Dijkstra (MultiQueue)", filePath, N, (ll)edges.size(), maxThreads,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      bestStats.Counters({{"sequential_ns", (double)sequentialNs},
+                                          {"one_thread_ns", (double)oneThreadNs},
+                                          {"best_ns", (double)bestNs},
+                                          {"best_threads", (double)bestThreads},
+                                          {"heaps_per_thread", (double)heapsPerThread},
+                                          {"speedup", (double)sequentialNs / bestNs},
+                                          {"extra_settles", (double)(bestSettles - reachable)}})});
+
+    return 0;
+}
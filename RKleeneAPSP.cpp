@@ -0,0 +1,99 @@
+/* [Description]
+ * This program computes all-pairs shortest paths with the recursive R-Kleene algorithm from min_plus.h.
+ * Instead of streaming the whole N x N matrix once per intermediate vertex like Floyd-Warshall, it splits the
+ * matrix into quadrants and closes them recursively with min-plus products, which keeps the working set
+ * inside the caches at every level and lets independent products run in parallel.
+ * The result is checked against the blocked Floyd-Warshall from the same header and both times are printed.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
+ *
+ * Libraries:
+ * - iostream: For printing messages and errors to stdout.
+ * - chrono: For measuring elapsed execution time.
+ * - vector, string: Edge list and file path handling.
+ * - graph_csr.h: Fast edge-list loader.
+ * - min_plus.h: DistanceMatrix, R-Kleene and blocked Floyd-Warshall.
+ * - numa_alloc.h: Huge-page / NUMA options for the matrices (GRAPH_MEMORY).
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include "graph_csr.h"
+#include "min_plus.h"
+#include "memory_stats.h"
+#include "bench_report.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    // GRAPH_MEMORY=huge,interleave (numa_alloc.h) switches the matrices to huge pages / interleaved nodes.
+    const MemoryOptions &memory = GlobalMemoryOptions();
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    string filePath = argc > 1 ? argv[1] : "graph_N1000_D0.100000_negtrue_1.in";
+    const int threads = argc > 2 ? stoi(argv[2]) : 0; // 0 = all hardware threads
+
+    BeginMemoryPhase("load graph");
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not read " << filePath << '\n';
+        return 1;
+    }
+
+    DistanceMatrix dist(N + 1);
+    for (const Edge &e : edges) {
+        dist.at(e.from, e.to) = min<int32_t>(dist.at(e.from, e.to), (int32_t)e.weight);
+    }
+    DistanceMatrix reference = dist;
+
+    auto begin = chrono::steady_clock::now();
+    BeginMemoryPhase("R-Kleene");
+    RKleeneAPSP(dist, threads);
+    auto mid = chrono::steady_clock::now();
+    BeginMemoryPhase("blocked Floyd-Warshall");
+    BlockedFloydWarshall(reference, 256, threads);
+    auto end = chrono::steady_clock::now();
+    EndMemoryPhase();
+    TrackStructure("edge list", VectorBytes(edges));
+    TrackStructure("distance matrix (each of 2)", (long long)dist.Bytes());
+
+    if (HasNegativeCycle(dist)) {
+        cout << "Warning: negative weight cycle detected.\n";
+        return 1;
+    }
+    if (!(dist == reference)) {
+        cout << "Error: R-Kleene and blocked Floyd-Warshall disagree.\n";
+        return 1;
+    }
+
+    // for (int j = 1; j <= N; ++j) {
+    //     if (dist.at(1, j) == MATRIX_INF) cout << "INF";
+    //     else cout << dist.at(1, j);
+    //     if (j < N) cout << ' ';
+    // }
+    // cout << '\n';
+
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "R-Kleene = " << chrono::duration_cast<chrono::nanoseconds>(mid - begin).count() << " ns\n";
+    cout << "Blocked Floyd-Warshall = " << chrono::duration_cast<chrono::nanoseconds>(end - mid).count() << " ns\n";
+    cout << "Memory: " << DescribeMemoryOptions(memory) << '\n';
+    WriteBenchRecord({"R-Kleene", filePath, N, (long long)edges.size(), threads,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      {{"r_kleene_ns", (double)chrono::duration_cast<chrono::nanoseconds>(mid - begin).count()},
+                       {"blocked_floyd_warshall_ns",
+                        (double)chrono::duration_cast<chrono::nanoseconds>(end - mid).count()}}});
+
+    return 0;
+}
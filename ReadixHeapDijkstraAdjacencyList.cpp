@@ -4,8 +4,12 @@
  * amortized time.  We avoid double‐pull on extract, use emplace, and reserve
  * adjacency lists for a small constant-factor speedup.
  *
- * Memory usage (VmPeak/VmRSS) before and after via /proc/self/status (Linux),
- * and elapsed time in nanoseconds via chrono.
+ * Memory usage before and after via memory_stats.h (heap counters per phase and
+ * per structure), and elapsed time in nanoseconds via chrono. With BENCH_OUTPUT
+ * set, the run is also appended as a record for BenchCompare (bench_report.h).
+ * Work counters (engine_stats.h) are printed when collectStats is on.
+ * The search reads the graph only through ForEachNeighbor (search_workspace.h), so the same loop runs on a
+ * CSRGraph or a DynamicGraph.
  *
  * Author: H. Hristov
  * Ruse, 2025
@@ -17,25 +21,16 @@
  #include <vector>
  #include <limits>
  #include "radix_heap.h"
+ #include "search_workspace.h"
+ #include "shortest_path_tree.h"
+ #include "engine_stats.h"
+ #include "memory_stats.h"
+ #include "bench_report.h"
  
  using namespace std;
  static constexpr long long INF = numeric_limits<long long>::max();
  
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
- void PrintMemoryUsage(){
-     ifstream status("/proc/self/status");
-     string line;
-     while(getline(status,line)){
-         if(line.find("VmPeak") != string::npos ||
-            line.find("VmRSS")  != string::npos){
-             cout<< line << "\n";
-         }
-     }
- }
- 
- int main(){
+ int main(int argc, char **argv){
      ios::sync_with_stdio(0);
      cin.tie(0);
      cout.tie(0);
@@ -43,8 +38,9 @@
      cout<<"Memory usage at start:\n";
      PrintMemoryUsage();
      auto begin = chrono::steady_clock::now();
+     BeginMemoryPhase("load graph");
  
-     const string filePath = "graph_N10000_D0.100000_negfalse_1.in";
+     string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negfalse_1.in";
      ifstream in(filePath);
      int N; in>>N;
      vector<vector<pair<int,long long>>> adj(N+1);
@@ -55,41 +51,71 @@
          adj[u].emplace_back(v,w);
      }
  
+     BeginMemoryPhase("Dijkstra (radix heap)");
      vector<long long> dist(N+1, INF);
      vector<char>     seen(N+1, 0);
      dist[1] = 0;
+
+     // Set to true to record the shortest-path tree; when false the tracker compiles away.
+     constexpr bool trackParents = false;
+     ParentTracker<trackParents> parents(N+1);
+     // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+     // the counters compile away.
+     constexpr bool collectStats = ENGINE_STATS_ENABLED;
+     EngineStats<collectStats> stats;
  
      radix_heap::pair_radix_heap<long long,int> pq;
      pq.emplace(0LL, 1);
+     stats.Push();
  
      while(!pq.empty()){
          // only one refill by calling top_value() first
          int      x = pq.top_value();
          long long d = pq.top_key();
          pq.pop();
-         if(seen[x]) continue;
+         stats.Pop();
+         if(seen[x]) {
+             stats.StalePop();
+             continue;
+         }
          seen[x] = 1;
  
-         for(auto &e: adj[x]){
-             int to = e.first;
-             if(seen[to]) continue;
-             long long nd = d + e.second;
+         ForEachNeighbor(adj, x, [&](int to, long long wt){
+             stats.Relax();
+             if(seen[to]) return;
+             long long nd = d + wt;
              if(nd < dist[to]){
                  dist[to] = nd;
+                 parents.Record(to, x);
+                 stats.Improve();
                  pq.emplace(nd, to);
+                 stats.Push();
              }
-         }
+         });
      }
  
+     EndMemoryPhase();
+     TrackStructure("adjacency list", NestedVectorBytes(adj));
+     TrackStructure("distances", VectorBytes(dist));
+     TrackStructure("seen", VectorBytes(seen));
+     TrackStructure("radix heap buckets", (long long)pq.bytes());
+ 
     //  for(int i=1;i<=N;++i){
     //      cout << (dist[i]==INF? -1 : dist[i]) << " ";
     //  }
      cout<<"\n\n";
  
+     if (!parents.Dump("spt_radix.bin", 1, dist, INF)) cout << "Error: could not write the tree.\n";
+
      auto end = chrono::steady_clock::now();
      cout<<"Memory usage after algorithm:\n";
      PrintMemoryUsage();
+     PrintMemoryReport();
      cout<<"Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end-begin).count() <<" ns\n";
+     stats.Print(cout);
+     WriteBenchRecord({"Dijkstra (radix heap)", filePath, N, AdjacencyEdgeCount(adj), 1,
+                       chrono::duration_cast<chrono::nanoseconds>(end-begin).count(),
+                       stats.Counters({{"queue_bytes", (double)pq.bytes()}})});
  
      return 0;
  }
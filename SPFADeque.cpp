@@ -3,16 +3,21 @@
  * with the Small-Label-First (SLF) optimization via a deque, which often outperforms the FIFO queue on sparse graphs.
  * Additionally, the program measures the time and memory consumption of this implementation
  * for each test graph and outputs these metrics.
- * Important note: Memory measurement is OS-dependent and works on Linux via /proc/self/status.
+ * Memory is measured with memory_stats.h: heap allocations, bytes and peak per phase and per data structure.
  *
  * Libraries:
  * - iostream: For printing messages and errors to stdout.
- * - fstream: For reading input graph files and the status file for memory usage.
+ * - fstream: For reading input graph files.
  * - chrono: For measuring elapsed execution time.
  * - vector: For storing adjacency lists and distance arrays.
  * - deque: For SPFA processing with SLF heuristic.
  * - limits: For INF definition.
  * - string: For file path handling.
+ * - shortest_path_tree.h: Opt-in parent tracking, path extraction and the binary tree dump.
+ * - engine_stats.h: Opt-in work counters (relaxations, queue operations, passes).
+ * - relax_prefetch.h: Opt-in software prefetching in the relaxation loop.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ * - bench_report.h: Machine-readable result record (BENCH_OUTPUT).
  *
  * Author: H. Hristov (modified)
  * Ruse, 2025
@@ -24,28 +29,17 @@
 #include <deque>
 #include <limits>
 #include <string>
+#include "shortest_path_tree.h"
+#include "engine_stats.h"
+#include "relax_prefetch.h"
+#include "memory_stats.h"
+#include "bench_report.h"
 
 using namespace std;
 using ll = long long;
 const ll INF = numeric_limits<ll>::max() / 4;
 
-/* This function measures the memory usage of the current program and prints it out.
- * The function will probably not work on Windows! The /proc/self/status file seems to be Linux-specific.
- */
-void PrintMemoryUsage()
-{
-    ifstream status("/proc/self/status");
-    string line;
-    while (getline(status, line))
-    {
-        if (line.find("VmPeak") != string::npos || line.find("VmRSS") != string::npos)
-        {
-            cout << line << "\n";
-        }
-    }
-}
-
-int main()
+int main(int argc, char **argv)
 {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -54,8 +48,9 @@ int main()
     PrintMemoryUsage();
 
     auto begin = chrono::steady_clock::now();
+    BeginMemoryPhase("load graph");
 
-    string filePath = "graph_N10000_D0.100000_negtrue_1.in";
+    string filePath = argc > 1 ? argv[1] : "graph_N10000_D0.100000_negtrue_1.in";
     ifstream fileStream(filePath);
 
     int N;
@@ -70,13 +65,27 @@ int main()
     }
 
     // SPFA algorithm from source 1 with deque + SLF
+    BeginMemoryPhase("SPFA (SLF deque)");
     vector<ll> dist(N + 1, INF);
     vector<bool> inQueue(N + 1, false);
     vector<int> cnt(N + 1, 0);
     deque<int> dq;
 
+    // Set to true to record the shortest-path tree; when false the tracker compiles away.
+    constexpr bool trackParents = false;
+    ParentTracker<trackParents> parents(N + 1);
+    // Set to true (or build with -DENGINE_STATS=1) to count relaxations and queue operations; when false
+    // the counters compile away.
+    constexpr bool collectStats = ENGINE_STATS_ENABLED;
+    EngineStats<collectStats> stats;
+    // Set to k > 0 (or build with -DPREFETCH_DISTANCE=k) to prefetch distances k edges ahead and the next
+    // vertex's adjacency row; when 0 the prefetches compile away.
+    constexpr int prefetchDistance = PREFETCH_DISTANCE_DEFAULT;
+    RelaxPrefetcher<prefetchDistance> prefetch;
+
     dist[1] = 0;
     dq.push_back(1);
+    stats.Push();
     inQueue[1] = true;
     bool negCycle = false;
 
@@ -84,16 +93,27 @@ int main()
     {
         int x = dq.front();
         dq.pop_front();
+        stats.Pop();
         inQueue[x] = false;
-        for (auto &pr : adj[x])
+        if (!dq.empty())
+            prefetch.Next(adj, dq.front(), dist);
+        const auto &row = adj[x];
+        prefetch.Start(row, dist);
+        for (size_t i = 0; i < row.size(); ++i)
         {
+            prefetch.Ahead(row, i, dist);
+            auto &pr = row[i];
+            stats.Relax();
             int y = pr.first;
             ll w2 = pr.second;
             if (dist[x] + w2 < dist[y])
             {
                 dist[y] = dist[x] + w2;
+                parents.Record(y, x);
+                stats.Improve();
                 if (!inQueue[y])
                 {
+                    stats.Push();
                     // SLF: push to front if smaller than current front
                     if (!dq.empty() && dist[y] < dist[dq.front()])
                     {
@@ -116,17 +136,31 @@ int main()
             break;
     }
 
+    EndMemoryPhase();
+    TrackStructure("adjacency list", NestedVectorBytes(adj));
+    TrackStructure("distances", VectorBytes(dist));
+    TrackStructure("inQueue", (long long)(inQueue.capacity() / 8));
+    TrackStructure("relaxation counts", VectorBytes(cnt));
+
     if (negCycle)
     {
         cout << "Warning: negative weight cycle detected.\n";
         return 1;
     }
 
+    if (!parents.Dump("spt_spfadeque.bin", 1, dist, INF / 2))
+        cout << "Error: could not write the tree.\n";
+
     auto end = chrono::steady_clock::now();
 
     cout << "\nMemory usage after algorithm:\n";
     PrintMemoryUsage();
+    PrintMemoryReport();
     cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+    stats.Print(cout);
+    WriteBenchRecord({"SPFA (SLF deque)", filePath, N, AdjacencyEdgeCount(adj), 1,
+                      chrono::duration_cast<chrono::nanoseconds>(end - begin).count(),
+                      stats.Counters({{"prefetch_distance", (double)prefetchDistance}})});
 
     return 0;
 }
@@ -0,0 +1,53 @@
+/* [Description]
+ * This program loads a shortest-path tree dumped by one of the single-source engines (built with
+ * trackParents = true) and answers path queries from it: for every target given on the command line it
+ * prints the distance and the path from the tree's source, extracted in O(path length).
+ *
+ * Usage: ./SPTQuery spt_dijkstra.bin 17 42 ...
+ *
+ * Libraries:
+ * - iostream: For printing the answers.
+ * - vector, string: Tree arrays and argument handling.
+ * - shortest_path_tree.h: ReadSPT and ExtractPath.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include "shortest_path_tree.h"
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " <tree file> <target> [target...]\n";
+        return 1;
+    }
+
+    int source;
+    vector<long long> dist;
+    vector<int> parent;
+    if (!ReadSPT(argv[1], source, dist, parent)) {
+        cout << "Error: " << argv[1] << " is not a shortest-path tree file.\n";
+        return 1;
+    }
+
+    for (int i = 2; i < argc; ++i) {
+        int t = stoi(argv[i]);
+        if (t < 0 || t >= (int)dist.size()) {
+            cout << t << ": no such vertex\n";
+            continue;
+        }
+        vector<int> path = ExtractPath(parent, source, t);
+        if (path.empty()) {
+            cout << source << " -> " << t << ": unreachable\n";
+            continue;
+        }
+        cout << source << " -> " << t << ": distance " << dist[t] << ", path";
+        for (int v : path) cout << ' ' << v;
+        cout << '\n';
+    }
+    return 0;
+}
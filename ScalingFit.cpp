@@ -0,0 +1,181 @@
+/* [Description]
+ * This program fits empirical complexity exponents to the records of a scaling sweep (scaling_sweep.sh, or any
+ * BENCH_OUTPUT file from bench_report.h). Runs on the same graph are averaged first. For every engine and thread
+ * count, and for the total time as well as every phase, it fits
+ *     time ~ C * n^a * m^b
+ * by least squares on log time, which separates the size and the density dependence when the sweep covers
+ * several densities (at a fixed Erdos-Renyi density m grows like n^2, so n and m alone are collinear). When the
+ * points cannot separate a and b, only time ~ C * m^b is fitted. For each density with at least two sizes the
+ * plain exponent time ~ n^a is printed as well, which is the number to compare with the O(...) of the paper.
+ * With a plot directory it also writes one data file per engine and a gnuplot script (scaling.gp) that draws
+ * total time against the number of edges on log-log axes into scaling.png.
+ *
+ * Usage: ./ScalingFit <results file> [plot directory]
+ *
+ * Libraries:
+ * - iostream, fstream: Printing the fits and writing the plot files.
+ * - string, vector, map, set: Records grouped per engine, metric and graph.
+ * - cmath: Logarithms for the log-log fits.
+ * - bench_report.h: ReadBenchResults for both record formats.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cmath>
+#include "bench_report.h"
+
+using namespace std;
+
+struct Point { double n, m, density, ns; };
+
+struct Fit { vector<double> coef; double r2 = 0; bool ok = false; };
+
+/* Least squares y = coef[0] + coef[1] x1 + ... on the given rows (x[i][0] must be 1).
+ * Fails if the normal equations are (nearly) singular, i.e. the columns are collinear.
+ */
+Fit LeastSquares(const vector<vector<double>> &x, const vector<double> &y) {
+    Fit fit;
+    size_t k = x.empty() ? 0 : x[0].size();
+    if (x.size() <= k) return fit;
+    vector<vector<double>> a(k, vector<double>(k + 1, 0));
+    for (size_t r = 0; r < x.size(); ++r) {
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < k; ++j) a[i][j] += x[r][i] * x[r][j];
+            a[i][k] += x[r][i] * y[r];
+        }
+    }
+    double scale = 0;
+    for (size_t i = 0; i < k; ++i) scale = max(scale, fabs(a[i][i]));
+    for (size_t c = 0; c < k; ++c) {
+        size_t pivot = c;
+        for (size_t r = c + 1; r < k; ++r)
+            if (fabs(a[r][c]) > fabs(a[pivot][c])) pivot = r;
+        if (fabs(a[pivot][c]) < 1e-9 * scale) return fit;
+        swap(a[c], a[pivot]);
+        for (size_t r = 0; r < k; ++r) {
+            if (r == c) continue;
+            double f = a[r][c] / a[c][c];
+            for (size_t j = c; j <= k; ++j) a[r][j] -= f * a[c][j];
+        }
+    }
+    fit.coef.resize(k);
+    for (size_t i = 0; i < k; ++i) fit.coef[i] = a[i][k] / a[i][i];
+
+    double mean = 0, total = 0, residual = 0;
+    for (double v : y) mean += v;
+    mean /= y.size();
+    for (size_t r = 0; r < x.size(); ++r) {
+        double predicted = 0;
+        for (size_t i = 0; i < k; ++i) predicted += fit.coef[i] * x[r][i];
+        residual += (y[r] - predicted) * (y[r] - predicted);
+        total += (y[r] - mean) * (y[r] - mean);
+    }
+    fit.r2 = total > 0 ? 1 - residual / total : 1;
+    fit.ok = true;
+    return fit;
+}
+
+void PrintFits(const string &title, const vector<Point> &points) {
+    vector<vector<double>> x2, x1;
+    vector<double> y;
+    for (const Point &p : points) {
+        x2.push_back({1, log(p.n), log(p.m)});
+        x1.push_back({1, log(p.m)});
+        y.push_back(log(p.ns));
+    }
+    cout.setf(ios::fixed);
+    cout.precision(2);
+    cout << title << " (" << points.size() << " graphs): ";
+    // With a single density log m is log n shifted and doubled (plus noise), so only m is fitted.
+    set<double> densities;
+    for (const Point &p : points) densities.insert(p.density);
+    Fit both = densities.size() > 1 ? LeastSquares(x2, y) : Fit();
+    Fit edges = LeastSquares(x1, y);
+    if (both.ok) cout << "time ~ n^" << both.coef[1] << " * m^" << both.coef[2] << " (R^2 = " << both.r2 << ")";
+    else if (edges.ok) cout << "time ~ m^" << edges.coef[1] << " (R^2 = " << edges.r2 << ")";
+    else cout << "not enough distinct graphs to fit";
+
+    map<double, vector<const Point *>> byDensity;
+    for (const Point &p : points) byDensity[p.density].push_back(&p);
+    for (auto &[density, group] : byDensity) {
+        vector<vector<double>> xn;
+        vector<double> yn;
+        for (const Point *p : group) {
+            xn.push_back({1, log(p->n)});
+            yn.push_back(log(p->ns));
+        }
+        Fit sizes = LeastSquares(xn, yn);
+        if (!sizes.ok) continue;
+        cout.unsetf(ios::fixed);
+        cout << "; D=" << density;
+        cout.setf(ios::fixed);
+        cout << ": n^" << sizes.coef[1];
+    }
+    cout << '\n';
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <results file> [plot directory]\n";
+        return 1;
+    }
+    vector<BenchResult> results;
+    if (!ReadBenchResults(argv[1], results)) {
+        cout << "Error: could not read " << argv[1] << '\n';
+        return 1;
+    }
+
+    // engine -> metric -> graph -> samples; graphs keep their n, m and density.
+    map<string, map<string, map<string, vector<double>>>> samples;
+    map<string, Point> graphs;
+    for (const BenchResult &r : results) {
+        if (r.record.n <= 0 || r.record.m <= 0) continue;
+        string engine = r.record.algorithm + " | " + to_string(r.record.threads) + " threads";
+        graphs[r.record.graph] = {(double)r.record.n, (double)r.record.m, r.density, 0};
+        if (r.record.totalNs > 0) samples[engine]["total"][r.record.graph].push_back((double)r.record.totalNs);
+        for (auto &[name, ns] : r.phaseNs)
+            if (ns > 0) samples[engine]["phase " + name][r.record.graph].push_back(ns);
+    }
+
+    string plotDir = argc > 2 ? argv[2] : "";
+    ofstream script;
+    if (!plotDir.empty()) {
+        script.open(plotDir + "/scaling.gp");
+        script << "set terminal png size 1200,800\nset output '" << plotDir << "/scaling.png'\n"
+               << "set logscale xy\nset xlabel 'edges (m)'\nset ylabel 'total time (s)'\nset key left top\nplot";
+    }
+    int plotted = 0;
+    for (auto &[engine, metrics] : samples) {
+        for (auto &[metric, perGraph] : metrics) {
+            vector<Point> points;
+            for (auto &[graph, values] : perGraph) {
+                Point p = graphs[graph];
+                for (double v : values) p.ns += v;
+                p.ns /= values.size();
+                points.push_back(p);
+            }
+            PrintFits(engine + " | " + metric, points);
+
+            if (!script.is_open() || metric != "total") continue;
+            string data = plotDir + "/scaling_" + to_string(plotted) + ".dat";
+            ofstream out(data);
+            out << "# " << engine << "\n# n m density seconds\n";
+            for (const Point &p : points) out << p.n << ' ' << p.m << ' ' << p.density << ' ' << p.ns / 1e9 << '\n';
+            script << (plotted ? ", \\\n    " : " ") << "'" << data << "' using 2:4 with points title '"
+                   << bench_report_internal::Clean(engine, "'") << "'";
+            ++plotted;
+        }
+    }
+    if (script.is_open()) {
+        if (!plotted) script << " 1 notitle";
+        script << '\n';
+        cout << "\nPlot: gnuplot " << plotDir << "/scaling.gp (" << plotted << " engines)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+/* [Description]
+ * This program is the command-line client of ShortestPathServer. It sends one request per invocation, or in
+ * bench mode drives the server with batches of random point-to-point queries from several connections at once
+ * and reports the latency seen by the clients next to the throughput.
+ * Distances are printed as numbers, or INF for unreachable targets.
+ *
+ * Usage: ./ShortestPathClient <socket> info
+ *        ./ShortestPathClient <socket> sssp <source> [source ...]       (one line of N+1 distances per source)
+ *        ./ShortestPathClient <socket> p2p <s> <t> [<s> <t> ...]
+ *        ./ShortestPathClient <socket> table <sources> -- <targets>     (e.g. table 1 2 3 -- 4 5)
+ *        ./ShortestPathClient <socket> stats
+ *        ./ShortestPathClient <socket> shutdown
+ *        ./ShortestPathClient <socket> bench [connections = 4] [requests per connection = 1000] [batch = 16]
+ *
+ * Libraries:
+ * - iostream, chrono, string, vector: Argument parsing, output and latency timing.
+ * - thread, random: Concurrent bench connections and random queries.
+ * - sys/socket.h, sys/un.h, unistd.h: The connection.
+ * - query_protocol.h: Request/answer layout and latency histograms.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "query_protocol.h"
+
+using namespace std;
+using ll = long long;
+
+int Connect(const string &socketPath) {
+    sockaddr_un address;
+    if (!UnixAddress(socketPath, address)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* Sends one request and reads its answer into answer (raw bytes). Returns false if the connection failed or
+ * the server rejected the request.
+ */
+bool Query(int fd, QueryType type, uint32_t count, uint32_t extra, const vector<int32_t> &payload,
+           vector<char> &answer) {
+    RequestHeader header{{QUERY_MAGIC[0], QUERY_MAGIC[1], QUERY_MAGIC[2], QUERY_MAGIC[3]}, type, count, extra};
+    ResponseHeader reply;
+    if (!WriteFull(fd, &header, sizeof(header)) ||
+        (!payload.empty() && !WriteFull(fd, payload.data(), payload.size() * sizeof(int32_t))) ||
+        !ReadFull(fd, &reply, sizeof(reply)))
+        return false;
+    answer.resize(reply.bytes);
+    if (!ReadFull(fd, answer.data(), reply.bytes)) return false;
+    return reply.status == QueryStatus::Ok;
+}
+
+void PrintDistances(const int64_t *d, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (i) cout << ' ';
+        if (d[i] == QUERY_UNREACHABLE) cout << "INF";
+        else cout << d[i];
+    }
+    cout << '\n';
+}
+
+int Bench(const string &socketPath, int connections, int requests, int batch) {
+    int probe = Connect(socketPath);
+    vector<char> answer;
+    if (probe < 0 || !Query(probe, QueryType::Info, 0, 0, {}, answer)) {
+        cout << "Error: cannot reach the server on " << socketPath << '\n';
+        return 1;
+    }
+    close(probe);
+    int vertexCount = (int)reinterpret_cast<const int64_t *>(answer.data())[0];
+
+    vector<LatencyHistogram> latency(connections);
+    vector<int> failed(connections, 0);
+    vector<thread> clients;
+    auto begin = chrono::steady_clock::now();
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c] {
+            int fd = Connect(socketPath);
+            if (fd < 0) {
+                failed[c] = requests;
+                return;
+            }
+            mt19937 rng(12345 + c);
+            // Vertex 0 exists only for 0-based files; picking from 1..N matches the other programs.
+            uniform_int_distribution<int> pick(1, max(1, vertexCount - 1));
+            vector<int32_t> pairs(2 * batch);
+            vector<char> reply;
+            for (int r = 0; r < requests; ++r) {
+                for (auto &v : pairs) v = pick(rng);
+                auto start = chrono::steady_clock::now();
+                if (!Query(fd, QueryType::Pairs, batch, 0, pairs, reply)) {
+                    failed[c] = requests - r;
+                    break;
+                }
+                auto elapsed = chrono::steady_clock::now() - start;
+                latency[c].Record(chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+            }
+            close(fd);
+        });
+    }
+    for (auto &t : clients) t.join();
+    auto end = chrono::steady_clock::now();
+
+    LatencyHistogram all;
+    int failures = 0;
+    for (int c = 0; c < connections; ++c) {
+        all.Merge(latency[c]);
+        failures += failed[c];
+    }
+    double seconds = chrono::duration_cast<chrono::nanoseconds>(end - begin).count() / 1e9;
+    cout << "Connections = " << connections << ", batch = " << batch << " pairs, failed requests = " << failures
+         << '\n';
+    cout << all.Report("client latency per batch") << '\n';
+    cout << "Throughput = " << all.Count() / seconds << " batches/s, " << all.Count() * batch / seconds
+         << " queries/s\n";
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " <socket> info | sssp <s>... | p2p <s> <t>... | table <s>... -- <t>... | "
+             << "stats | shutdown | bench [connections] [requests] [batch]\n";
+        return 1;
+    }
+    string socketPath = argv[1], command = argv[2];
+    vector<string> args(argv + 3, argv + argc);
+
+    if (command == "bench") {
+        int connections = args.size() > 0 ? stoi(args[0]) : 4;
+        int requests = args.size() > 1 ? stoi(args[1]) : 1000;
+        int batch = args.size() > 2 ? stoi(args[2]) : 16;
+        return Bench(socketPath, connections, requests, batch);
+    }
+
+    QueryType type;
+    uint32_t count = 0, extra = 0;
+    vector<int32_t> payload;
+    if (command == "info") type = QueryType::Info;
+    else if (command == "stats") type = QueryType::Stats;
+    else if (command == "shutdown") type = QueryType::Shutdown;
+    else if (command == "sssp") {
+        type = QueryType::SSSP;
+        for (auto &a : args) payload.push_back(stoi(a));
+        count = payload.size();
+    } else if (command == "p2p") {
+        type = QueryType::Pairs;
+        for (auto &a : args) payload.push_back(stoi(a));
+        if (payload.size() % 2) {
+            cout << "Error: p2p needs pairs of vertices.\n";
+            return 1;
+        }
+        count = payload.size() / 2;
+    } else if (command == "table") {
+        type = QueryType::Table;
+        vector<int32_t> targets;
+        bool afterSeparator = false;
+        for (auto &a : args) {
+            if (a == "--") afterSeparator = true;
+            else (afterSeparator ? targets : payload).push_back(stoi(a));
+        }
+        count = payload.size();
+        extra = targets.size();
+        payload.insert(payload.end(), targets.begin(), targets.end());
+    } else {
+        cout << "Error: unknown command " << command << '\n';
+        return 1;
+    }
+
+    int fd = Connect(socketPath);
+    if (fd < 0) {
+        cout << "Error: cannot connect to " << socketPath << '\n';
+        return 1;
+    }
+    vector<char> answer;
+    auto begin = chrono::steady_clock::now();
+    bool ok = Query(fd, type, count, extra, payload, answer);
+    auto end = chrono::steady_clock::now();
+    close(fd);
+    if (!ok) {
+        cout << "Error: the server rejected the request (bad vertex id or too large).\n";
+        return 1;
+    }
+
+    const int64_t *d = reinterpret_cast<const int64_t *>(answer.data());
+    size_t values = answer.size() / sizeof(int64_t);
+    switch (type) {
+        case QueryType::Info:
+            cout << "Vertices = " << d[0] << ", edges = " << d[1] << ", negative weights = " << (d[2] ? "yes" : "no")
+                 << '\n';
+            break;
+        case QueryType::SSSP:
+        case QueryType::Table: {
+            size_t rows = count ? count : 1, width = values / rows;
+            for (size_t r = 0; r < count; ++r) PrintDistances(d + r * width, width);
+            break;
+        }
+        case QueryType::Pairs: PrintDistances(d, values); break;
+        case QueryType::Stats: cout << string(answer.begin(), answer.end()); break;
+        default: cout << "Server is shutting down.\n"; break;
+    }
+    cout << "Elapsed time = " << chrono::duration_cast<chrono::nanoseconds>(end - begin).count() << " ns\n";
+
+    return 0;
+}
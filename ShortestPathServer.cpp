@@ -0,0 +1,420 @@
+/* [Description]
+ * This program is a resident shortest-path query service. It loads a graph once with the memory-mapped loader
+ * into a CSR graph, then answers batched requests from other processes over a Unix domain socket, so that the
+ * loading cost, which dominates a single-query program, is paid once instead of per query.
+ * The binary protocol is described in query_protocol.h: single-source rows, point-to-point pairs and
+ * distance tables, plus an info, a statistics and a shutdown request. ShortestPathClient.cpp speaks it.
+ * - Requests, not connections, are dispatched to a pool of workers. The main thread waits with epoll on the
+ *   listening socket and on every idle connection; when a connection becomes readable it is queued for the
+ *   pool, and the worker that takes it answers one request and re-arms it (EPOLLONESHOT), so no connection
+ *   is watched twice and idle or long-lived clients hold no worker. Requests of one connection are answered
+ *   in order, those of different connections by all workers in parallel. A client that sends part of a
+ *   request and stalls, or stops reading its answer, holds a worker for at most STALL_TIMEOUT_MS (socket
+ *   receive and send timeouts), after which its connection is closed.
+ * - Each worker owns a SearchWorkspace on its own QueryArena and reuses its request and answer buffers, so once
+ *   they have grown to their working size a request makes no heap allocations. Single-source rows are streamed
+ *   one source at a time instead of building the whole answer in memory.
+ * - Graphs with negative weights are reweighted once at startup with Johnson potentials
+ *   (johnson_potentials.h), so every query is a plain Dijkstra; answers are corrected by h[t] - h[s]. A graph
+ *   with a negative cycle is rejected.
+ * - Every request's latency (from its connection becoming readable, so including the time it waited for a
+ *   worker, to its answer being written) is recorded in a per-worker, per-type histogram; the Stats request
+ *   returns the merged percentiles and the server prints them when it shuts down.
+ *
+ * Usage: ./ShortestPathServer <graph file> [socket = /tmp/sp_server.sock] [workers = all cores]
+ *
+ * Libraries:
+ * - iostream, chrono, string, vector, deque: Reports, latency timing, buffers and the connection queue.
+ * - thread, mutex, condition_variable, atomic: The worker pool.
+ * - sys/socket.h, sys/un.h, unistd.h, fcntl.h, csignal: The listening socket.
+ * - sys/time.h: The stall timeouts of the connections.
+ * - sys/epoll.h, sys/eventfd.h: Readiness of the connections and the stop signal of the dispatch loop.
+ * - graph_csr.h: Memory-mapped loader and CSR graph.
+ * - johnson_potentials.h: Potentials for graphs with negative weights.
+ * - search_workspace.h, query_arena.h: Per-worker reusable search state.
+ * - query_protocol.h: Request/answer layout and latency histograms.
+ * - memory_stats.h: Heap counters per phase and per data structure.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "graph_csr.h"
+#include "johnson_potentials.h"
+#include "search_workspace.h"
+#include "query_arena.h"
+#include "query_protocol.h"
+#include "memory_stats.h"
+
+using namespace std;
+using ll = long long;
+
+const char *TypeName(QueryType type) {
+    switch (type) {
+        case QueryType::Info: return "info";
+        case QueryType::SSSP: return "sssp";
+        case QueryType::Pairs: return "pairs";
+        case QueryType::Table: return "table";
+        case QueryType::Stats: return "stats";
+        default: return "shutdown";
+    }
+}
+
+constexpr int TYPE_COUNT = 6;
+// Longest a worker waits for the rest of a request, or for the client to take its answer.
+constexpr int STALL_TIMEOUT_MS = 2000;
+
+struct Worker {
+    explicit Worker(int vertexCount)
+        : arena(QueryArena::WorkspaceBytes(vertexCount, vertexCount)), ws(vertexCount, arena.Resource()) {}
+
+    QueryArena arena;
+    SearchWorkspace ws;
+    vector<int32_t> request;
+    vector<int64_t> answer;
+    mutex latencyMutex;
+    LatencyHistogram latency[TYPE_COUNT];
+};
+
+// A connection with a request waiting, and when the poller saw it become readable.
+struct ReadyConnection {
+    int fd;
+    chrono::steady_clock::time_point readable;
+};
+
+class Server {
+public:
+    Server(const CSRGraph &g, const vector<ll> &h, bool negative, int listenFd, int workers)
+        : g_(g), h_(h), negative_(negative), listenFd_(listenFd) {
+        for (int i = 0; i < workers; ++i) workers_.push_back(make_unique<Worker>(g.VertexCount()));
+    }
+
+    /* The dispatch loop: accepts connections and queues every readable one for the workers until a Shutdown
+     * request or an error stops it. Returns false if epoll could not be set up.
+     */
+    bool Run() {
+        epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+        stopFd_ = eventfd(0, EFD_CLOEXEC);
+        fcntl(listenFd_, F_SETFL, fcntl(listenFd_, F_GETFL) | O_NONBLOCK);
+        if (epollFd_ < 0 || stopFd_ < 0 || !Watch(listenFd_, EPOLL_CTL_ADD, false) ||
+            !Watch(stopFd_, EPOLL_CTL_ADD, false))
+            return false;
+
+        vector<thread> pool;
+        for (auto &w : workers_) pool.emplace_back([this, worker = w.get()] { Serve(*worker); });
+        epoll_event events[64];
+        bool running = true;
+        while (running) {
+            int count = epoll_wait(epollFd_, events, 64, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            auto now = chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == stopFd_) {
+                    running = false;
+                } else if (fd == listenFd_) {
+                    Accept();
+                } else {
+                    lock_guard<mutex> lock(mutex_);
+                    pending_.push_back({fd, now});
+                    ready_.notify_one();
+                }
+            }
+        }
+        Stop();
+        for (auto &t : pool) t.join();
+        for (int fd : open_) close(fd);
+        open_.clear();
+        close(stopFd_);
+        close(epollFd_);
+        return true;
+    }
+
+    string LatencyReport() {
+        LatencyHistogram merged[TYPE_COUNT], all;
+        for (auto &w : workers_) {
+            lock_guard<mutex> lock(w->latencyMutex);
+            for (int t = 0; t < TYPE_COUNT; ++t) merged[t].Merge(w->latency[t]);
+        }
+        string report;
+        for (int t = 0; t < TYPE_COUNT; ++t) {
+            all.Merge(merged[t]);
+            if (merged[t].Count()) report += merged[t].Report(TypeName((QueryType)t)) + '\n';
+        }
+        return report + all.Report("all") + '\n';
+    }
+
+private:
+    // Adds fd to the epoll set or re-arms it; connections are one-shot, so only one worker ever owns one.
+    bool Watch(int fd, int operation, bool oneShot) {
+        epoll_event event{};
+        event.events = (uint32_t)EPOLLIN | (oneShot ? (uint32_t)EPOLLONESHOT : 0u);
+        event.data.fd = fd;
+        return epoll_ctl(epollFd_, operation, fd, &event) == 0;
+    }
+
+    void Accept() {
+        while (true) {
+            int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;   // EAGAIN: no more pending connections
+            }
+            // A client that stalls mid-request, or stops reading its answer, times out instead of pinning the
+            // worker that took the request; the connection is then closed.
+            timeval timeout{STALL_TIMEOUT_MS / 1000, STALL_TIMEOUT_MS % 1000 * 1000};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            lock_guard<mutex> lock(mutex_);
+            if (stopping_ || !Watch(fd, EPOLL_CTL_ADD, true)) {
+                close(fd);
+                continue;
+            }
+            open_.push_back(fd);
+        }
+    }
+
+    // Stops the dispatch loop and wakes every worker, including those blocked reading a request's payload.
+    void Stop() {
+        lock_guard<mutex> lock(mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+        uint64_t one = 1;
+        if (write(stopFd_, &one, sizeof(one)) < 0) {}
+        for (int fd : open_) shutdown(fd, SHUT_RD);
+        ready_.notify_all();
+    }
+
+    void Serve(Worker &worker) {
+        while (true) {
+            ReadyConnection connection;
+            {
+                unique_lock<mutex> lock(mutex_);
+                ready_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+                if (pending_.empty()) return;
+                connection = pending_.front();
+                pending_.pop_front();
+            }
+            if (HandleRequest(worker, connection)) {
+                lock_guard<mutex> lock(mutex_);
+                if (!stopping_ && Watch(connection.fd, EPOLL_CTL_MOD, true)) continue;
+            }
+            lock_guard<mutex> lock(mutex_);
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+            erase(open_, connection.fd);
+            close(connection.fd);
+        }
+    }
+
+    // Answers one request; false when the connection is finished (closed, malformed or shutting down).
+    bool HandleRequest(Worker &worker, const ReadyConnection &connection) {
+        int fd = connection.fd;
+        RequestHeader header;
+        if (!ReadFull(fd, &header, sizeof(header))) return false;
+        bool ok = memcmp(header.magic, QUERY_MAGIC, 4) == 0 && (uint32_t)header.type < TYPE_COUNT;
+        bool keepOpen = ok && Answer(worker, fd, header, ok);
+        if (!ok) {
+            ResponseHeader bad{QueryStatus::BadRequest, 0, 0};
+            WriteFull(fd, &bad, sizeof(bad));
+            return false;
+        }
+        auto end = chrono::steady_clock::now();
+        lock_guard<mutex> lock(worker.latencyMutex);
+        worker.latency[(int)header.type].Record(
+            chrono::duration_cast<chrono::nanoseconds>(end - connection.readable).count());
+        return keepOpen;
+    }
+
+    // Distance in the original weights, or QUERY_UNREACHABLE.
+    int64_t Distance(const SearchWorkspace &ws, int s, int t) const {
+        ll d = ws.Dist(t);
+        if (d == SearchWorkspace::INF) return QUERY_UNREACHABLE;
+        return negative_ ? d - h_[s] + h_[t] : d;
+    }
+
+    bool ValidVertex(int32_t v) const { return v >= 0 && v < g_.VertexCount(); }
+
+    // Reads count int32 values of the payload; ok turns false if they are too many or any is not a vertex.
+    bool ReadVertices(Worker &worker, int fd, uint64_t count, bool &ok) {
+        if (count * sizeof(int32_t) > QUERY_MAX_RESPONSE_BYTES) return ok = false;
+        worker.request.resize(count);
+        if (!ReadFull(fd, worker.request.data(), count * sizeof(int32_t))) return false;
+        for (int32_t v : worker.request)
+            if (!ValidVertex(v)) ok = false;
+        return true;
+    }
+
+    bool Reply(int fd, const void *data, uint64_t bytes) {
+        ResponseHeader header{QueryStatus::Ok, 0, bytes};
+        return WriteFull(fd, &header, sizeof(header)) && (bytes == 0 || WriteFull(fd, data, bytes));
+    }
+
+    // Returns false if the connection should be closed; sets ok = false for a malformed request.
+    bool Answer(Worker &worker, int fd, const RequestHeader &header, bool &ok) {
+        int n = g_.VertexCount();
+        SearchWorkspace &ws = worker.ws;
+        vector<int32_t> &in = worker.request;
+        vector<int64_t> &out = worker.answer;
+        switch (header.type) {
+            case QueryType::Info: {
+                int64_t info[3] = {n, g_.EdgeCount(), negative_};
+                return Reply(fd, info, sizeof(info));
+            }
+            case QueryType::SSSP: {
+                uint64_t bytes = (uint64_t)header.count * n * sizeof(int64_t);
+                if (bytes > QUERY_MAX_RESPONSE_BYTES) return ok = false;
+                if (!ReadVertices(worker, fd, header.count, ok) || !ok) return false;
+                ResponseHeader reply{QueryStatus::Ok, 0, bytes};
+                if (!WriteFull(fd, &reply, sizeof(reply))) return false;
+                out.resize(n);
+                for (int s : in) {
+                    Dijkstra(g_, s, ws);
+                    for (int t = 0; t < n; ++t) out[t] = Distance(ws, s, t);
+                    if (!WriteFull(fd, out.data(), n * sizeof(int64_t))) return false;
+                }
+                return true;
+            }
+            case QueryType::Pairs: {
+                if (!ReadVertices(worker, fd, 2 * (uint64_t)header.count, ok) || !ok) return false;
+                out.clear();
+                for (size_t i = 0; i < in.size(); i += 2) {
+                    Dijkstra(g_, in[i], ws, in[i + 1]);
+                    out.push_back(Distance(ws, in[i], in[i + 1]));
+                }
+                return Reply(fd, out.data(), out.size() * sizeof(int64_t));
+            }
+            case QueryType::Table: {
+                uint64_t sources = header.count, targets = header.extra;
+                if (sources * targets * sizeof(int64_t) > QUERY_MAX_RESPONSE_BYTES) return ok = false;
+                if (!ReadVertices(worker, fd, sources + targets, ok) || !ok) return false;
+                out.clear();
+                for (size_t i = 0; i < sources; ++i) {
+                    Dijkstra(g_, in[i], ws);
+                    for (size_t j = sources; j < in.size(); ++j) out.push_back(Distance(ws, in[i], in[j]));
+                }
+                return Reply(fd, out.data(), out.size() * sizeof(int64_t));
+            }
+            case QueryType::Stats: {
+                string report = LatencyReport();
+                return Reply(fd, report.data(), report.size());
+            }
+            default: {
+                Reply(fd, nullptr, 0);
+                Stop();
+                return false;
+            }
+        }
+    }
+
+    const CSRGraph &g_;
+    const vector<ll> &h_;
+    bool negative_;
+    int listenFd_, epollFd_ = -1, stopFd_ = -1;
+    vector<unique_ptr<Worker>> workers_;
+    mutex mutex_;
+    condition_variable ready_;
+    deque<ReadyConnection> pending_;
+    vector<int> open_;
+    bool stopping_ = false;
+};
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <graph file> [socket = /tmp/sp_server.sock] [workers = all cores]\n";
+        return 1;
+    }
+    string filePath = argv[1];
+    string socketPath = argc > 2 ? argv[2] : "/tmp/sp_server.sock";
+    int workers = argc > 3 ? stoi(argv[3]) : 0;
+    if (workers <= 0) workers = max(1u, thread::hardware_concurrency());
+    signal(SIGPIPE, SIG_IGN);
+
+    cout << "Memory usage at start:\n";
+    PrintMemoryUsage();
+
+    BeginMemoryPhase("load graph");
+    auto begin = chrono::steady_clock::now();
+    int N;
+    vector<Edge> edges;
+    if (!LoadEdgeList(filePath, N, edges)) {
+        cout << "Error: could not open " << filePath << '\n';
+        return 1;
+    }
+    CSRGraph g = BuildCSR(N+1, edges);
+    bool negative = false;
+    for (const Edge &e : edges) negative |= e.weight < 0;
+    vector<Edge>().swap(edges);
+
+    // Reweight once, so every query is a Dijkstra over non-negative reduced costs.
+    vector<ll> h;
+    if (negative) {
+        BeginMemoryPhase("potentials");
+        if (!ComputePotentials(g, h)) {
+            cout << "Error: the graph contains a negative cycle.\n";
+            return 1;
+        }
+        for (int u = 0; u < g.VertexCount(); ++u)
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; ++i) g.weights[i] += h[u] - h[g.targets[i]];
+    }
+    EndMemoryPhase();
+    auto loaded = chrono::steady_clock::now();
+
+    sockaddr_un address;
+    if (!UnixAddress(socketPath, address)) {
+        cout << "Error: socket path too long: " << socketPath << '\n';
+        return 1;
+    }
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, (sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, 128) != 0) {
+        cout << "Error: cannot listen on " << socketPath << '\n';
+        return 1;
+    }
+
+    cout << "Graph: N = " << N << ", M = " << g.EdgeCount() << (negative ? ", negative weights (reweighted)" : "")
+         << ", loaded in " << chrono::duration_cast<chrono::milliseconds>(loaded - begin).count() << " ms\n";
+    cout << "Listening on " << socketPath << " with " << workers << " workers" << endl;
+
+    BeginMemoryPhase("serve");
+    Server server(g, h, negative, listenFd, workers);
+    if (!server.Run()) {
+        cout << "Error: cannot set up epoll\n";
+        return 1;
+    }
+    EndMemoryPhase();
+    close(listenFd);
+    unlink(socketPath.c_str());
+    auto end = chrono::steady_clock::now();
+
+    TrackStructure("CSR graph", (ll)g.Bytes());
+    TrackStructure("potentials", (ll)(h.capacity() * sizeof(ll)));
+    TrackStructure("workspace per worker", (ll)SearchWorkspace(N+1).Bytes());
+
+    cout << "\nMemory usage after algorithm:\n";
+    PrintMemoryUsage();
+    PrintMemoryReport();
+    cout << "\nRequest latency:\n" << server.LatencyReport();
+    cout << "Uptime = " << chrono::duration_cast<chrono::seconds>(end - loaded).count() << " s\n";
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* [Description]
+ * This header contains a compressed in-memory distance matrix for all-pairs results. On the test graphs the
+ * distances in one row span a small range (weights in [-10, 10], small diameter), so instead of 64 bits per
+ * entry each row is stored frame-of-reference style: a per-row base (the smallest finite distance) and a
+ * per-row bit width just large enough for max - base, with every entry packed back to back as base-relative
+ * codes. When a row has unreachable entries, the all-ones code of its width marks them.
+ * - Get(s, t) is random access: one unaligned 64-bit load at bit offset t * width, a shift and a mask.
+ * - DecodeRow(s, out) unpacks a whole row; with AVX2 (selected at runtime) four entries are gathered, shifted,
+ *   masked and rebased per instruction.
+ * Rows are independent, so they can be packed in any order and replaced.
+ *
+ * Libraries:
+ * - vector, cstdint, cstring, algorithm: Packed words, row headers and unaligned loads.
+ * - immintrin.h: AVX2 gather decoding.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <immintrin.h>
+
+class PackedDistanceMatrix {
+public:
+    // An n x n matrix whose rows all start out unreachable; entries >= unreachable are treated as unreachable.
+    PackedDistanceMatrix(int n = 0, long long unreachable = 0)
+        : n_(n), unreachable_(unreachable), rows_(n) {
+        for (Row &r : rows_) r.base = unreachable;
+    }
+
+    int Size() const { return n_; }
+
+    // Packs row s from n values.
+    void SetRow(int s, const long long *values) {
+        Row &r = rows_[s];
+        long long lo = unreachable_, hi = 0;
+        bool missing = false;
+        for (int t = 0; t < n_; ++t) {
+            if (values[t] >= unreachable_) missing = true;
+            else if (lo == unreachable_) lo = hi = values[t];
+            else {
+                lo = std::min(lo, values[t]);
+                hi = std::max(hi, values[t]);
+            }
+        }
+        r.base = lo;
+        r.unreachableCode = missing && lo != unreachable_;
+        r.width = 0;
+        if (lo == unreachable_) {   // no finite entry at all
+            r.words.clear();
+            return;
+        }
+        uint64_t largest = (uint64_t)(hi - lo) + r.unreachableCode;   // the all-ones code stays free if needed
+        while (r.width < 64 && (largest >> r.width) != 0) ++r.width;
+        if (r.width > 57) r.width = 64;   // the unaligned loads below need width + 7 <= 64
+        uint64_t mask = Mask(r.width);
+
+        // One spare word at the end, so that every unaligned 8-byte load stays inside the row.
+        r.words.assign(((size_t)n_ * r.width + 63) / 64 + 1, 0);
+        for (int t = 0; t < n_; ++t) {
+            uint64_t code = values[t] >= unreachable_ ? mask : (uint64_t)(values[t] - lo);
+            size_t bit = (size_t)t * r.width;
+            r.words[bit / 64] |= code << (bit % 64);
+            if (bit % 64 + r.width > 64) r.words[bit / 64 + 1] |= code >> (64 - bit % 64);
+        }
+    }
+
+    long long Get(int s, int t) const {
+        const Row &r = rows_[s];
+        if (r.width == 0) return r.base;
+        uint64_t code = Code(r, t);
+        return (r.unreachableCode && code == Mask(r.width)) ? unreachable_ : r.base + (long long)code;
+    }
+
+    // Unpacks row s into out[0..n).
+    void DecodeRow(int s, long long *out) const {
+        const Row &r = rows_[s];
+        if (r.width == 0 || r.width == 64) {
+            for (int t = 0; t < n_; ++t) out[t] = Get(s, t);
+            return;
+        }
+        if (HasAVX2()) DecodeRowAVX2(r, out);
+        else
+            for (int t = 0; t < n_; ++t) out[t] = Get(s, t);
+    }
+
+    // Bytes held by the packed rows and their headers.
+    size_t Bytes() const {
+        size_t bytes = sizeof(Row) * rows_.size();
+        for (const Row &r : rows_) bytes += r.words.size() * sizeof(uint64_t);
+        return bytes;
+    }
+
+private:
+    struct Row {
+        long long base = 0;
+        int width = 0;
+        bool unreachableCode = false;
+        std::vector<uint64_t> words;
+    };
+
+    int n_;
+    long long unreachable_;
+    std::vector<Row> rows_;
+
+    static uint64_t Mask(int width) { return width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1; }
+
+    static bool HasAVX2() {
+        static const bool has = __builtin_cpu_supports("avx2");
+        return has;
+    }
+
+    static uint64_t Code(const Row &r, int t) {
+        if (r.width == 64) return r.words[t];
+        size_t bit = (size_t)t * r.width;
+        uint64_t word;
+        std::memcpy(&word, (const char *)r.words.data() + bit / 8, 8);
+        return (word >> (bit % 8)) & Mask(r.width);
+    }
+
+    __attribute__((target("avx2")))
+    void DecodeRowAVX2(const Row &r, long long *out) const {
+        const long long *bytes = (const long long *)r.words.data();
+        const __m256i mask = _mm256_set1_epi64x((long long)Mask(r.width));
+        const __m256i base = _mm256_set1_epi64x(r.base);
+        const __m256i missing = _mm256_set1_epi64x(unreachable_);
+        const __m256i seven = _mm256_set1_epi64x(7);
+        const __m256i step = _mm256_set1_epi64x(4LL * r.width);
+        __m256i bit = _mm256_setr_epi64x(0, r.width, 2LL * r.width, 3LL * r.width);
+        int t = 0;
+        for (; t + 4 <= n_; t += 4) {
+            __m256i words = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(bit, 3), 1);
+            __m256i code = _mm256_and_si256(_mm256_srlv_epi64(words, _mm256_and_si256(bit, seven)), mask);
+            __m256i value = _mm256_add_epi64(code, base);
+            if (r.unreachableCode) value = _mm256_blendv_epi8(value, missing, _mm256_cmpeq_epi64(code, mask));
+            _mm256_storeu_si256((__m256i *)(out + t), value);
+            bit = _mm256_add_epi64(bit, step);
+        }
+        for (; t < n_; ++t) {
+            uint64_t code = Code(r, t);
+            out[t] = (r.unreachableCode && code == Mask(r.width)) ? unreachable_ : r.base + (long long)code;
+        }
+    }
+};
@@ -0,0 +1,197 @@
+/* [Description]
+ * This header contains a binary file format for all-pairs shortest path results and the code to write and read
+ * it, so that APSP is computed once and other processes can answer dist(s, t) from the file without recomputing.
+ * Layout (little-endian): a 4096-byte header, then the n x n matrix row by row with no padding, each entry an
+ * int32 or int64 (header.elementBytes). Unreachable pairs hold INT32_MAX / INT64_MAX.
+ * Header: char[4] "APSP", uint32 version, uint32 elementBytes, uint32 vertexCount, uint64 dataOffset (4096),
+ * the rest zeros. The data starts on a page boundary, so a mapped row is page-aligned whenever its byte offset is.
+ * - APSPWriter streams rows through an 8 MiB buffer with large sequential write() calls and writes the header
+ *   last, so an interrupted run never leaves a file that looks valid.
+ * - APSPFile maps the file read-only; Dist(s, t) is one load at dataOffset + (s * n + t) * elementBytes.
+ *   Pages are faulted in on demand and shared through the page cache between all processes serving the file.
+ *
+ * Libraries:
+ * - cstdint, cstring, limits, string, vector: Header layout, sentinels and the write buffer.
+ * - fcntl.h, sys/mman.h, sys/stat.h, unistd.h: File I/O and memory mapping (Linux/POSIX).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct APSPFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t elementBytes;
+    uint32_t vertexCount;
+    uint64_t dataOffset;
+};
+
+constexpr uint64_t APSP_DATA_OFFSET = 4096;
+
+// int32 entries suffice when no shortest path can reach INT32_MAX in absolute value.
+inline int APSPElementBytes(long long maxAbsWeight, int vertexCount) {
+    return maxAbsWeight * (long long)vertexCount < std::numeric_limits<int32_t>::max() ? 4 : 8;
+}
+
+class APSPWriter {
+public:
+    APSPWriter() = default;
+    APSPWriter(const APSPWriter &) = delete;
+    APSPWriter &operator=(const APSPWriter &) = delete;
+    ~APSPWriter() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // Creates the file for a vertexCount x vertexCount matrix of elementBytes (4 or 8) entries.
+    bool Open(const std::string &path, int vertexCount, int elementBytes) {
+        if (elementBytes != 4 && elementBytes != 8) return false;
+        fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+        vertexCount_ = vertexCount;
+        elementBytes_ = elementBytes;
+        rows_ = 0;
+        buffer_.assign(APSP_DATA_OFFSET, 0);   // placeholder header, overwritten by Close()
+        buffer_.reserve(BUFFER_BYTES);
+        return true;
+    }
+
+    /* Appends the next row. Entries >= unreachable are stored as the unreachable sentinel of the entry width.
+     * T is any integer type holding distances (the callers use long long and int32_t).
+     */
+    template<typename T>
+    bool AppendRow(const T *row, long long unreachable) {
+        if (fd_ < 0 || rows_ == vertexCount_) return false;
+        size_t at = buffer_.size();
+        buffer_.resize(at + (size_t)vertexCount_ * elementBytes_);
+        char *out = &buffer_[at];
+        for (int j = 0; j < vertexCount_; ++j) {
+            long long d = (long long)row[j];
+            if (elementBytes_ == 4) {
+                int32_t e = d >= unreachable ? std::numeric_limits<int32_t>::max() : (int32_t)d;
+                std::memcpy(out + (size_t)j * 4, &e, 4);
+            } else {
+                int64_t e = d >= unreachable ? std::numeric_limits<int64_t>::max() : (int64_t)d;
+                std::memcpy(out + (size_t)j * 8, &e, 8);
+            }
+        }
+        ++rows_;
+        return buffer_.size() < BUFFER_BYTES || Flush();
+    }
+
+    // Flushes the remaining rows and writes the header. Returns false on I/O errors or missing rows.
+    bool Close() {
+        if (fd_ < 0) return false;
+        bool ok = rows_ == vertexCount_ && Flush();
+        APSPFileHeader header{};
+        std::memcpy(header.magic, "APSP", 4);
+        header.version = 1;
+        header.elementBytes = (uint32_t)elementBytes_;
+        header.vertexCount = (uint32_t)vertexCount_;
+        header.dataOffset = APSP_DATA_OFFSET;
+        ok = ok && pwrite(fd_, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+        ok = (close(fd_) == 0) && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+private:
+    static constexpr size_t BUFFER_BYTES = size_t(8) << 20;
+    int fd_ = -1, vertexCount_ = 0, elementBytes_ = 0, rows_ = 0;
+    std::vector<char> buffer_;
+
+    bool Flush() {
+        size_t done = 0;
+        while (done < buffer_.size()) {
+            ssize_t written = write(fd_, buffer_.data() + done, buffer_.size() - done);
+            if (written <= 0) return false;
+            done += (size_t)written;
+        }
+        buffer_.clear();
+        return true;
+    }
+};
+
+class APSPFile {
+public:
+    static constexpr long long UNREACHABLE = std::numeric_limits<long long>::max();
+
+    APSPFile() = default;
+    APSPFile(const APSPFile &) = delete;
+    APSPFile &operator=(const APSPFile &) = delete;
+    ~APSPFile() { Close(); }
+
+    // Maps the file. Returns false if it is missing, truncated or not in the APSP format.
+    bool Open(const std::string &path) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < APSP_DATA_OFFSET) {
+            close(fd);
+            return false;
+        }
+        void *mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return false;
+        mapped_ = (const char *)mapped;
+        size_ = (size_t)st.st_size;
+
+        APSPFileHeader header;
+        std::memcpy(&header, mapped_, sizeof(header));
+        uint64_t n = header.vertexCount;
+        bool ok = std::memcmp(header.magic, "APSP", 4) == 0 && header.version == 1 &&
+                  (header.elementBytes == 4 || header.elementBytes == 8) && header.dataOffset == APSP_DATA_OFFSET &&
+                  n > 0 && n <= (uint64_t)std::numeric_limits<int>::max() &&
+                  // n * n * elementBytes could overflow for a corrupt header, so bound n by division instead.
+                  n <= (size_ - APSP_DATA_OFFSET) / header.elementBytes / n;
+        if (!ok) {
+            Close();
+            return false;
+        }
+        vertexCount_ = (int)n;
+        elementBytes_ = (int)header.elementBytes;
+        data_ = mapped_ + header.dataOffset;
+        // Lookups jump around the matrix; read-ahead would only pull in pages nobody asked for.
+        madvise((void *)mapped_, size_, MADV_RANDOM);
+        return true;
+    }
+
+    void Close() {
+        if (mapped_) munmap((void *)mapped_, size_);
+        mapped_ = data_ = nullptr;
+        size_ = 0;
+        vertexCount_ = elementBytes_ = 0;
+    }
+
+    int VertexCount() const { return vertexCount_; }
+    int ElementBytes() const { return elementBytes_; }
+
+    // Distance from s to t, or UNREACHABLE. O(1): a single load from the mapping.
+    long long Dist(int s, int t) const {
+        size_t index = (size_t)s * vertexCount_ + t;
+        if (elementBytes_ == 4) {
+            int32_t d;
+            std::memcpy(&d, data_ + index * 4, 4);
+            return d == std::numeric_limits<int32_t>::max() ? UNREACHABLE : d;
+        }
+        int64_t d;
+        std::memcpy(&d, data_ + index * 8, 8);
+        return d == std::numeric_limits<int64_t>::max() ? UNREACHABLE : d;
+    }
+
+private:
+    const char *mapped_ = nullptr, *data_ = nullptr;
+    size_t size_ = 0;
+    int vertexCount_ = 0, elementBytes_ = 0;
+};
@@ -0,0 +1,58 @@
+/* [Description]
+ * This header contains the next-hop matrix used to reconstruct shortest paths after an all-pairs computation.
+ * next(i, j) is the vertex that follows i on a shortest path from i to j, so a path is recovered in
+ * O(path length) by following next-hops. The index type is chosen from N by the caller: uint16_t halves the
+ * overhead compared with uint32_t whenever the vertex ids fit, and even uint32_t is only half the size of the
+ * long long distance matrix it accompanies.
+ *
+ * Libraries:
+ * - vector, cstdint, limits: Matrix storage, index types and the "no path" marker.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+template<typename IndexT>
+class NextHopMatrix {
+public:
+    static constexpr IndexT NONE = std::numeric_limits<IndexT>::max();
+
+    // Returns true if vertex ids 0..vertexCount-1 and the NONE marker fit into IndexT.
+    static bool Fits(int vertexCount) { return (unsigned long long)vertexCount < NONE; }
+
+    explicit NextHopMatrix(int vertexCount)
+        : n_(vertexCount), next_((size_t)vertexCount * vertexCount, NONE) {
+        for (int i = 0; i < n_; ++i) at(i, i) = (IndexT)i;
+    }
+
+    IndexT &at(int i, int j) { return next_[(size_t)i * n_ + j]; }
+    IndexT at(int i, int j) const { return next_[(size_t)i * n_ + j]; }
+
+    void SetEdge(int u, int v) { at(u, v) = (IndexT)v; }
+
+    // Called when the path i -> k -> j became the best one: its first hop is the first hop towards k.
+    void Relax(int i, int j, int k) { at(i, j) = at(i, k); }
+
+    // The vertices of a shortest path from s to t, both included; empty if t is unreachable from s.
+    std::vector<int> Path(int s, int t) const {
+        std::vector<int> path;
+        if (at(s, t) == NONE) return path;
+        path.push_back(s);
+        while (s != t && (int)path.size() <= n_) { // the bound only matters with negative cycles
+            s = at(s, t);
+            path.push_back(s);
+        }
+        return path;
+    }
+
+    size_t Bytes() const { return next_.size() * sizeof(IndexT); }
+
+private:
+    int n_;
+    std::vector<IndexT> next_;
+};
@@ -0,0 +1,229 @@
+/* [Description]
+ * This header contains the machine-readable output of the benchmark programs. At the end of a run a program
+ * fills a BenchRecord (algorithm, graph, N, M, threads, total time, its own counters) and calls
+ * WriteBenchRecord(); the record is completed with the phases measured by memory_stats.h (time, allocations,
+ * peak heap per phase), the process-wide heap high-water mark and maximum RSS, the git commit and a timestamp,
+ * and appended to the file named by the BENCH_OUTPUT environment variable:
+ * - *.csv: one row per run, with a header row when the file is new. Phases and counters are packed into one
+ *   column each as "name=value;name=value".
+ * - anything else: JSON Lines, one object per run.
+ * Without BENCH_OUTPUT nothing is written, so the programs behave as before. Repeated runs append to the same
+ * file, which gives BenchCompare.cpp the samples it needs for its significance test:
+ *     for i in 1 2 3 4 5; do BENCH_OUTPUT=base.jsonl ./DijkstraAdjacencyList; done
+ * The commit is taken from BENCH_COMMIT if set, otherwise from "git rev-parse --short HEAD".
+ * ReadBenchResults() parses both formats back for the tools (BenchCompare.cpp, ScalingFit.cpp).
+ *
+ * Libraries:
+ * - string, vector, map, fstream, sstream, cstdio, cstdlib, ctime: Building, appending and reading the records.
+ * - sys/resource.h: Maximum resident set size.
+ * - memory_stats.h: Phases and heap counters.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/resource.h>
+#include "memory_stats.h"
+
+struct BenchRecord {
+    std::string algorithm, graph;
+    long long n = 0, m = 0;
+    int threads = 1;
+    long long totalNs = 0;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+// A record read back from a BENCH_OUTPUT file by ReadBenchResults().
+struct BenchResult {
+    BenchRecord record;
+    double density = 0;
+    std::vector<std::pair<std::string, double>> phaseNs;
+};
+
+namespace bench_report_internal {
+
+// Density of the file name ("graph_N1000_D0.100000_negfalse_1.in"), or m / (n (n - 1)) if it has none.
+inline double Density(const BenchRecord &r) {
+    size_t pos = r.graph.find("_D");
+    if (pos != std::string::npos) return std::atof(r.graph.c_str() + pos + 2);
+    return r.n > 1 ? (double)r.m / ((double)r.n * (r.n - 1)) : 0.0;
+}
+
+inline std::string GitCommit() {
+    if (const char *env = std::getenv("BENCH_COMMIT")) return env;
+    std::string commit;
+    if (FILE *pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r")) {
+        char buffer[64];
+        if (fgets(buffer, sizeof(buffer), pipe)) commit = buffer;
+        pclose(pipe);
+    }
+    while (!commit.empty() && (commit.back() == '\n' || commit.back() == '\r')) commit.pop_back();
+    return commit.empty() ? "unknown" : commit;
+}
+
+// Names come from the programs themselves; quotes, backslashes and separators are replaced, not escaped.
+inline std::string Clean(std::string s, const char *forbidden) {
+    for (char &c : s)
+        for (const char *f = forbidden; *f; ++f)
+            if (c == *f) c = '_';
+    return s;
+}
+
+// Raw value of "key": in a JSON line written below: a string without its quotes, or a number, array or object as text.
+inline std::string JsonField(const std::string &line, const std::string &key) {
+    size_t pos = line.find("\"" + key + "\":");
+    if (pos == std::string::npos) return "";
+    pos += key.size() + 3;
+    if (line[pos] == '"') return line.substr(pos + 1, line.find('"', pos + 1) - pos - 1);
+    if (line[pos] == '[') return line.substr(pos, line.find(']', pos) - pos + 1);
+    if (line[pos] == '{') return line.substr(pos, line.find('}', pos) - pos + 1);
+    return line.substr(pos, line.find_first_of(",}", pos) - pos);
+}
+
+inline std::vector<std::string> Split(const std::string &s, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(s);
+    std::string part;
+    while (std::getline(stream, part, separator)) parts.push_back(part);
+    if (!s.empty() && s.back() == separator) parts.push_back("");
+    return parts;
+}
+
+// "name=value;name=value" (CSV) or {"name":value,...} (JSON counters).
+inline std::vector<std::pair<std::string, double>> Pairs(const std::string &packed, bool json) {
+    std::vector<std::pair<std::string, double>> pairs;
+    std::string body = json && packed.size() >= 2 ? packed.substr(1, packed.size() - 2) : packed;
+    for (const std::string &item : Split(body, json ? ',' : ';')) {
+        size_t eq = item.find(json ? ':' : '=');
+        if (eq == std::string::npos) continue;
+        std::string name = item.substr(0, eq);
+        if (json && name.size() >= 2) name = name.substr(1, name.size() - 2);
+        pairs.emplace_back(name, std::atof(item.c_str() + eq + 1));
+    }
+    return pairs;
+}
+
+} // namespace bench_report_internal
+
+// Number of edges of an adjacency list (vector of per-vertex vectors), for BenchRecord::m.
+template<class Adjacency>
+long long AdjacencyEdgeCount(const Adjacency &adj) {
+    long long m = 0;
+    for (const auto &list : adj) m += (long long)list.size();
+    return m;
+}
+
+/* Appends r to BENCH_OUTPUT (if set), together with the memory_stats.h phases and the environment of the run.
+ * Returns false only if the file could not be written.
+ */
+inline bool WriteBenchRecord(const BenchRecord &r) {
+    using namespace bench_report_internal;
+    const char *path = std::getenv("BENCH_OUTPUT");
+    if (!path || !*path) return true;
+    std::string file = path;
+    bool csv = file.size() >= 4 && file.compare(file.size() - 4, 4, ".csv") == 0;
+
+    EndMemoryPhase();
+    std::vector<MemoryPhaseStats> phases = MemoryPhaseRecords();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::string commit = Clean(GitCommit(), "\",;\\");
+    long long timestamp = (long long)std::time(nullptr);
+
+    std::ostringstream line;
+    line.precision(10);
+    if (csv) {
+        const char *bad = "\",;=\\\n";
+        line << Clean(r.algorithm, bad) << ',' << Clean(r.graph, bad) << ',' << r.n << ',' << r.m << ','
+             << Density(r) << ',' << r.threads << ',' << r.totalNs << ',';
+        for (size_t i = 0; i < phases.size(); ++i)
+            line << (i ? ";" : "") << Clean(phases[i].name, bad) << '=' << phases[i].ns;
+        line << ',';
+        for (size_t i = 0; i < r.counters.size(); ++i)
+            line << (i ? ";" : "") << Clean(r.counters[i].first, bad) << '=' << r.counters[i].second;
+        line << ',' << MaxHeapBytes() << ',' << usage.ru_maxrss << ',' << commit << ',' << timestamp << '\n';
+    } else {
+        const char *bad = "\"\\\n";
+        line << "{\"algorithm\":\"" << Clean(r.algorithm, bad) << "\",\"graph\":\"" << Clean(r.graph, bad)
+             << "\",\"n\":" << r.n << ",\"m\":" << r.m << ",\"density\":" << Density(r) << ",\"threads\":" << r.threads
+             << ",\"total_ns\":" << r.totalNs << ",\"phases\":[";
+        for (size_t i = 0; i < phases.size(); ++i)
+            line << (i ? "," : "") << "{\"name\":\"" << Clean(phases[i].name, bad) << "\",\"ns\":" << phases[i].ns
+                 << ",\"allocations\":" << phases[i].allocations << ",\"bytes\":" << phases[i].bytes
+                 << ",\"peak_heap_bytes\":" << phases[i].peakBytes << '}';
+        line << "],\"counters\":{";
+        for (size_t i = 0; i < r.counters.size(); ++i)
+            line << (i ? "," : "") << '"' << Clean(r.counters[i].first, bad) << "\":" << r.counters[i].second;
+        line << "},\"peak_heap_bytes\":" << MaxHeapBytes() << ",\"max_rss_kb\":" << usage.ru_maxrss
+             << ",\"commit\":\"" << commit << "\",\"timestamp\":" << timestamp << "}\n";
+    }
+
+    bool fresh = !std::ifstream(file).good();
+    std::ofstream out(file, std::ios::app);
+    if (!out) return false;
+    if (csv && fresh)
+        out << "algorithm,graph,n,m,density,threads,total_ns,phases_ns,counters,peak_heap_bytes,max_rss_kb,commit,"
+               "timestamp\n";
+    out << line.str();
+    return (bool)out;
+}
+
+/* Reads every record of a BENCH_OUTPUT file, JSON Lines or CSV (detected per line), and appends it to results.
+ * Per-phase allocation counts are not read back; only the times are needed for comparisons and fits.
+ */
+inline bool ReadBenchResults(const std::string &path, std::vector<BenchResult> &results) {
+    using namespace bench_report_internal;
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    std::vector<std::string> header;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        BenchResult r;
+        if (line[0] == '{') {
+            r.record.algorithm = JsonField(line, "algorithm");
+            r.record.graph = JsonField(line, "graph");
+            r.record.n = std::atoll(JsonField(line, "n").c_str());
+            r.record.m = std::atoll(JsonField(line, "m").c_str());
+            r.record.threads = std::atoi(JsonField(line, "threads").c_str());
+            r.record.totalNs = std::atoll(JsonField(line, "total_ns").c_str());
+            r.record.counters = Pairs(JsonField(line, "counters"), true);
+            r.density = std::atof(JsonField(line, "density").c_str());
+            std::string phases = JsonField(line, "phases");
+            const std::string key = "{\"name\":";
+            for (size_t pos = phases.find(key); pos != std::string::npos; pos = phases.find(key, pos + 1)) {
+                std::string object = phases.substr(pos, phases.find('}', pos) - pos + 1);
+                r.phaseNs.emplace_back(JsonField(object, "name"), std::atof(JsonField(object, "ns").c_str()));
+            }
+        } else if (header.empty() || line.compare(0, 10, "algorithm,") == 0) {
+            header = Split(line, ',');
+            continue;
+        } else {
+            std::vector<std::string> cells = Split(line, ',');
+            std::map<std::string, std::string> row;
+            for (size_t i = 0; i < header.size() && i < cells.size(); ++i) row[header[i]] = cells[i];
+            r.record.algorithm = row["algorithm"];
+            r.record.graph = row["graph"];
+            r.record.n = std::atoll(row["n"].c_str());
+            r.record.m = std::atoll(row["m"].c_str());
+            r.record.threads = std::atoi(row["threads"].c_str());
+            r.record.totalNs = std::atoll(row["total_ns"].c_str());
+            r.record.counters = Pairs(row["counters"], false);
+            r.density = std::atof(row["density"].c_str());
+            r.phaseNs = Pairs(row["phases_ns"], false);
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
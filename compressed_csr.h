@@ -0,0 +1,123 @@
+/* [Description]
+ * This header contains a compressed variant of the CSR graph for graphs whose adjacency arrays dominate RAM.
+ * Each vertex's edges are sorted by target and written into one byte stream as (gap, weight) records:
+ * - the gap to the previous target (the first one to 0) as a LEB128 varint: 7 bits per byte, high bit set on
+ *   every byte but the last, so the gaps of a sparse random graph mostly take 1-2 bytes instead of 4;
+ * - the weight in a narrow type W chosen by the caller (int8_t holds the [-10, 10] weights of the test graphs).
+ * Only one offset per vertex is kept (where its records start). Edges are decoded on the fly while scanning,
+ * trading a few instructions per edge for much less memory traffic. The graph is read through
+ * ForEachNeighbor(g, u, f) / VertexCount(g), so the generic Dijkstra, SPFA and potential code run on it as-is.
+ *
+ * Libraries:
+ * - vector, algorithm, cstdint, cstring, limits: Byte stream, sorting and weight packing.
+ * - graph_csr.h: Edge.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "graph_csr.h"
+
+template<typename W>
+struct CompressedCSRGraph {
+    std::vector<uint64_t> offsets;   // VertexCount()+1 entries, records of u are bytes [offsets[u], offsets[u+1])
+    std::vector<uint8_t> bytes;
+
+    int VertexCount() const { return (int)offsets.size() - 1; }
+    size_t Bytes() const { return offsets.size() * sizeof(uint64_t) + bytes.size(); }
+};
+
+// True if every weight of edges fits in W, so that BuildCompressedCSR<W> is lossless.
+template<typename W>
+bool WeightsFit(const std::vector<Edge> &edges) {
+    for (const Edge &e : edges)
+        if (e.weight < std::numeric_limits<W>::min() || e.weight > std::numeric_limits<W>::max()) return false;
+    return true;
+}
+
+// Bytes of gap as a LEB128 varint.
+inline size_t VarintBytes(uint32_t gap) {
+    size_t n = 1;
+    for (; gap >= 0x80; gap >>= 7) ++n;
+    return n;
+}
+
+/* Encodes the graph straight from the edge list, without building a CSRGraph first: the only per-edge memory
+ * besides the edge list and the output is one 4-byte edge index (a counting sort by source), where a CSRGraph
+ * would add 12 bytes per edge and make the peak of the build higher than that of the plain CSR. A first pass
+ * sorts each row by target and measures its records, so the byte stream is allocated once at its exact size.
+ * At most 2^32 - 1 edges.
+ */
+template<typename W>
+CompressedCSRGraph<W> BuildCompressedCSR(int vertexCount, const std::vector<Edge> &edges) {
+    std::vector<uint32_t> rowStart(vertexCount + 1, 0);
+    for (const Edge &e : edges) ++rowStart[e.from + 1];
+    for (int u = 0; u < vertexCount; ++u) rowStart[u + 1] += rowStart[u];
+    std::vector<uint32_t> order(edges.size());
+    // rowStart[u] serves as the insertion cursor of row u, which leaves it at the start of row u + 1.
+    for (uint32_t i = 0; i < (uint32_t)edges.size(); ++i) order[rowStart[edges[i].from]++] = i;
+    for (int u = vertexCount; u > 0; --u) rowStart[u] = rowStart[u - 1];
+    rowStart[0] = 0;
+
+    CompressedCSRGraph<W> g;
+    g.offsets.assign(vertexCount + 1, 0);
+    auto byTarget = [&](uint32_t a, uint32_t b) {
+        return edges[a].to != edges[b].to ? edges[a].to < edges[b].to : edges[a].weight < edges[b].weight;
+    };
+    for (int u = 0; u < vertexCount; ++u) {
+        std::sort(order.begin() + rowStart[u], order.begin() + rowStart[u + 1], byTarget);
+        uint32_t previous = 0;
+        uint64_t size = 0;
+        for (uint32_t i = rowStart[u]; i < rowStart[u + 1]; ++i) {
+            uint32_t v = (uint32_t)edges[order[i]].to;
+            size += VarintBytes(v - previous) + sizeof(W);
+            previous = v;
+        }
+        g.offsets[u + 1] = g.offsets[u] + size;
+    }
+
+    g.bytes.resize(g.offsets[vertexCount]);
+    uint8_t *out = g.bytes.data();
+    for (int u = 0; u < vertexCount; ++u) {
+        uint32_t previous = 0;
+        for (uint32_t i = rowStart[u]; i < rowStart[u + 1]; ++i) {
+            const Edge &e = edges[order[i]];
+            uint32_t gap = (uint32_t)e.to - previous;
+            previous = (uint32_t)e.to;
+            while (gap >= 0x80) {
+                *out++ = (uint8_t)(gap | 0x80);
+                gap >>= 7;
+            }
+            *out++ = (uint8_t)gap;
+            W narrow = (W)e.weight;
+            std::memcpy(out, &narrow, sizeof(W));
+            out += sizeof(W);
+        }
+    }
+    return g;
+}
+
+template<typename W, typename F>
+inline void ForEachNeighbor(const CompressedCSRGraph<W> &g, int u, F &&f) {
+    const uint8_t *p = g.bytes.data() + g.offsets[u], *end = g.bytes.data() + g.offsets[u + 1];
+    uint32_t v = 0;
+    while (p < end) {
+        // Most gaps fit in one byte; the loop only runs for the rest.
+        uint32_t gap = *p & 0x7f;
+        for (int shift = 7; *p++ & 0x80; shift += 7) gap |= (uint32_t)(*p & 0x7f) << shift;
+        v += gap;
+        W w;
+        std::memcpy(&w, p, sizeof(W));
+        p += sizeof(W);
+        f((int)v, (long long)w);
+    }
+}
+
+template<typename W>
+inline int VertexCount(const CompressedCSRGraph<W> &g) { return g.VertexCount(); }
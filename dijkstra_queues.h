@@ -0,0 +1,75 @@
+/* [Description]
+ * This header contains monotone priority queues for Dijkstra's algorithm on non-negative integer weights, with
+ * the same interface as BinaryHeapQueue in search_workspace.h (Clear, Empty, Push, Pop), so QueueDijkstra()
+ * accepts any of them. Dijkstra only ever pushes keys that are at least the last popped key, which both exploit.
+ * - RadixHeapQueue: pair_radix_heap from radix_heap.h. Each key moves down at most 64 buckets over its lifetime,
+ *   so a run costs O(M + N log C) instead of O(M log N), with plain vector appends instead of sift-up/down.
+ * - DialQueue: Dial's buckets for a known maximum edge weight C. All live keys lie in [d, d + C], so C + 1
+ *   buckets used as a ring are enough; Push is O(1) and Pop scans forward over empty buckets, O(M + D) per run
+ *   where D is the largest distance. Worth it when C is small, as after Johnson's reweighting it often is.
+ *   Its buckets are std::pmr and can come from a QueryArena (query_arena.h).
+ * Both keep their storage across Clear(), so a reused queue stops allocating once it has reached its working size.
+ *
+ * Libraries:
+ * - vector, memory_resource, utility: Buckets and (distance, vertex) pairs.
+ * - radix_heap.h: pair_radix_heap.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "radix_heap.h"
+
+class RadixHeapQueue {
+public:
+    void Clear() { heap_.clear(); }
+    bool Empty() const { return heap_.empty(); }
+    void Push(long long d, int v) { heap_.push(d, v); }
+
+    std::pair<long long, int> Pop() {
+        std::pair<long long, int> top(heap_.top_key(), heap_.top_value());
+        heap_.pop();
+        return top;
+    }
+
+private:
+    radix_heap::pair_radix_heap<long long, int> heap_;
+};
+
+class DialQueue {
+public:
+    explicit DialQueue(long long maxWeight = 0, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : buckets_(maxWeight + 1, resource) {}
+
+    void Clear() {
+        if (size_ > 0) {
+            for (auto &bucket : buckets_) bucket.clear();
+        }
+        size_ = 0;
+        current_ = 0;
+    }
+
+    bool Empty() const { return size_ == 0; }
+
+    void Push(long long d, int v) {
+        buckets_[d % buckets_.size()].push_back(v);
+        ++size_;
+    }
+
+    std::pair<long long, int> Pop() {
+        std::pmr::vector<int> *bucket = &buckets_[current_ % buckets_.size()];
+        while (bucket->empty()) bucket = &buckets_[++current_ % buckets_.size()];
+        int v = bucket->back();
+        bucket->pop_back();
+        --size_;
+        return {current_, v};
+    }
+
+private:
+    std::pmr::vector<std::pmr::vector<int>> buckets_;
+    long long size_ = 0, current_ = 0;
+};
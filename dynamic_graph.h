@@ -0,0 +1,214 @@
+/* [Description]
+ * This header contains a mutable graph store for graphs that change between queries. Edges live in a CSR base
+ * (each vertex's targets sorted, so an edge is found by binary search) plus a small per-vertex delta log:
+ * - inserting an edge that is not in the base appends it to the vertex's log,
+ * - changing the weight of a base edge updates it in place,
+ * - removing a base edge only sets a tombstone, removing a logged edge swaps it out of the log.
+ * Once the logs and tombstones reach a quarter of the base size, Compact() merges everything back into a fresh
+ * CSR in parallel (per-vertex degrees, prefix sum, then each thread fills a range of vertices). Compaction costs
+ * O(N + M) and happens at most once per M/4 updates, so updates stay cheap in the amortized sense while edge
+ * scans remain almost entirely contiguous.
+ * Engines read the graph through ForEachNeighbor(g, u, f), which also exists for CSRGraph and AdjacencyList,
+ * so the same engine code runs on any of the three.
+ *
+ * Libraries:
+ * - vector, algorithm: Base arrays, delta logs, sorting and binary search.
+ * - thread: Parallel compaction.
+ * - graph_csr.h: Edge and CSRGraph.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "graph_csr.h"
+
+class DynamicGraph {
+public:
+    explicit DynamicGraph(int vertexCount = 0, const std::vector<Edge> &edges = {})
+        : base_(BuildCSR(vertexCount, edges)), delta_(vertexCount) {
+        for (int u = 0; u < vertexCount; ++u) SortRow(u);
+        removed_.assign(base_.targets.size(), 0);
+        liveEdges_ = (long long)base_.targets.size();
+    }
+
+    int VertexCount() const { return base_.VertexCount(); }
+    long long EdgeCount() const { return liveEdges_; }
+    int Compactions() const { return compactions_; }
+    // Bytes held by the base CSR, the tombstones and the logs.
+    size_t Bytes() const {
+        size_t bytes = base_.Bytes() + removed_.capacity() + delta_.capacity() * sizeof(delta_[0]);
+        for (const auto &log : delta_) bytes += log.capacity() * sizeof(log[0]);
+        return bytes;
+    }
+
+    // Looks up the weight of (u, v). Returns false if the edge does not exist.
+    bool FindEdge(int u, int v, long long &weight) const {
+        int i = FindBase(u, v);
+        if (i >= 0 && !removed_[i]) {
+            weight = base_.weights[i];
+            return true;
+        }
+        for (auto [to, w] : delta_[u]) {
+            if (to == v) {
+                weight = w;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Inserts (u, v) or changes its weight. Returns true and sets oldWeight if the edge already existed.
+     * O(log deg(u)) for base edges plus a scan of u's (short) log, and an amortized share of compaction.
+     */
+    bool SetEdge(int u, int v, long long weight, long long *oldWeight = nullptr) {
+        bool existed = false;
+        int i = FindBase(u, v);
+        if (i >= 0) {
+            existed = !removed_[i];
+            if (existed && oldWeight) *oldWeight = base_.weights[i];
+            if (!existed) {
+                removed_[i] = 0;
+                --tombstones_;
+                ++liveEdges_;
+            }
+            base_.weights[i] = weight;
+            return existed;
+        }
+        for (auto &e : delta_[u]) {
+            if (e.first == v) {
+                if (oldWeight) *oldWeight = e.second;
+                e.second = weight;
+                return true;
+            }
+        }
+        delta_[u].emplace_back(v, weight);
+        ++logged_;
+        ++liveEdges_;
+        MaybeCompact();
+        return false;
+    }
+
+    // Removes (u, v). Returns true and sets oldWeight if the edge existed.
+    bool RemoveEdge(int u, int v, long long *oldWeight = nullptr) {
+        int i = FindBase(u, v);
+        if (i >= 0 && !removed_[i]) {
+            if (oldWeight) *oldWeight = base_.weights[i];
+            removed_[i] = 1;
+            ++tombstones_;
+            --liveEdges_;
+            MaybeCompact();
+            return true;
+        }
+        auto &log = delta_[u];
+        for (auto &e : log) {
+            if (e.first == v) {
+                if (oldWeight) *oldWeight = e.second;
+                e = log.back();
+                log.pop_back();
+                --logged_;
+                --liveEdges_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls f(v, w) for every live edge (u, v, w): first the contiguous base row, then u's log.
+    template<typename F>
+    void ForEachNeighbor(int u, F &&f) const {
+        for (int i = base_.offsets[u]; i < base_.offsets[u + 1]; ++i)
+            if (!removed_[i]) f(base_.targets[i], base_.weights[i]);
+        for (auto [v, w] : delta_[u]) f(v, w);
+    }
+
+    // Merges the logs and drops the tombstones, rebuilding the base CSR with the given number of threads.
+    void Compact(int threads = 0) {
+        int n = VertexCount();
+        if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::max(1, std::min(threads, n));
+        auto parallelFor = [&](auto body) {
+            std::vector<std::thread> pool;
+            for (int t = 0; t < threads; ++t) {
+                int from = (int)((long long)n * t / threads), to = (int)((long long)n * (t + 1) / threads);
+                pool.emplace_back([=, &body] { for (int u = from; u < to; ++u) body(u); });
+            }
+            for (auto &th : pool) th.join();
+        };
+
+        CSRGraph next;
+        next.offsets.assign(n + 1, 0);
+        parallelFor([&](int u) {
+            int live = 0;
+            for (int i = base_.offsets[u]; i < base_.offsets[u + 1]; ++i) live += !removed_[i];
+            next.offsets[u + 1] = live + (int)delta_[u].size();
+        });
+        for (int u = 0; u < n; ++u) next.offsets[u + 1] += next.offsets[u];
+        next.targets.resize(next.offsets[n]);
+        next.weights.resize(next.offsets[n]);
+        parallelFor([&](int u) {
+            auto &log = delta_[u];
+            std::sort(log.begin(), log.end());
+            int out = next.offsets[u];
+            size_t j = 0;
+            for (int i = base_.offsets[u]; i < base_.offsets[u + 1]; ++i) {
+                if (removed_[i]) continue;
+                for (; j < log.size() && log[j].first < base_.targets[i]; ++j, ++out) {
+                    next.targets[out] = log[j].first;
+                    next.weights[out] = log[j].second;
+                }
+                next.targets[out] = base_.targets[i];
+                next.weights[out++] = base_.weights[i];
+            }
+            for (; j < log.size(); ++j, ++out) {
+                next.targets[out] = log[j].first;
+                next.weights[out] = log[j].second;
+            }
+            std::vector<std::pair<int, long long>>().swap(log);
+        });
+
+        base_ = std::move(next);
+        removed_.assign(base_.targets.size(), 0);
+        logged_ = tombstones_ = 0;
+        ++compactions_;
+    }
+
+private:
+    CSRGraph base_;
+    std::vector<char> removed_;
+    std::vector<std::vector<std::pair<int, long long>>> delta_;
+    long long liveEdges_ = 0, logged_ = 0, tombstones_ = 0;
+    int compactions_ = 0;
+
+    void SortRow(int u) {
+        int from = base_.offsets[u], to = base_.offsets[u + 1];
+        std::vector<std::pair<int, long long>> row;
+        row.reserve(to - from);
+        for (int i = from; i < to; ++i) row.emplace_back(base_.targets[i], base_.weights[i]);
+        if (std::is_sorted(row.begin(), row.end())) return;
+        std::sort(row.begin(), row.end());
+        for (int i = from; i < to; ++i) {
+            base_.targets[i] = row[i - from].first;
+            base_.weights[i] = row[i - from].second;
+        }
+    }
+
+    int FindBase(int u, int v) const {
+        auto first = base_.targets.begin() + base_.offsets[u], last = base_.targets.begin() + base_.offsets[u + 1];
+        auto it = std::lower_bound(first, last, v);
+        return (it != last && *it == v) ? (int)(it - base_.targets.begin()) : -1;
+    }
+
+    void MaybeCompact() {
+        if (logged_ + tombstones_ > std::max<long long>(1024, (long long)base_.targets.size() / 4)) Compact();
+    }
+};
+
+template<typename F>
+inline void ForEachNeighbor(const DynamicGraph &g, int u, F &&f) { g.ForEachNeighbor(u, std::forward<F>(f)); }
+
+inline int VertexCount(const DynamicGraph &g) { return g.VertexCount(); }
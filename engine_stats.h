@@ -0,0 +1,93 @@
+/* [Description]
+ * This header contains the work counters shared by the shortest-path engines, so that two engines can be
+ * compared by how much work they do and not only by how long it takes (why SPFADeque beats SPFA on one graph
+ * and loses on another, how many heap entries Dijkstra discards, ...).
+ * - EngineStats<Enabled>: engines call Relax() for every edge they examine (Relax(count) for a block of them,
+ *   e.g. a min-plus tile product whose individual improvements are not observed), Improve() when it lowers a
+ *   distance, Push()/Pop()/StalePop() for their queue, DecreaseKey() for indexed heaps and Pass() for every
+ *   round over all edges or vertices (Bellman-Ford, Floyd-Warshall). Like ParentTracker, with Enabled = false
+ *   the class is empty and every call compiles to nothing, so the hot loops of the default build are unchanged.
+ * - Print() adds one line to the benchmark report and Counters() appends the values to a BenchRecord's
+ *   counters (bench_report.h); both do nothing when disabled.
+ * Each program picks the mode with its own "constexpr bool collectStats"; building with -DENGINE_STATS=1
+ * switches the default of all of them at once (e.g. for a scaling_sweep.sh run).
+ *
+ * Libraries:
+ * - ostream, string, vector, utility: The report line and the counter list.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef ENGINE_STATS
+#define ENGINE_STATS 0
+#endif
+
+constexpr bool ENGINE_STATS_ENABLED = ENGINE_STATS != 0;
+
+using StatCounters = std::vector<std::pair<std::string, double>>;
+
+template<bool Enabled>
+class EngineStats;
+
+template<>
+class EngineStats<false> {
+public:
+    void Relax() {}
+    void Relax(long long) {}
+    void Improve() {}
+    void Push() {}
+    void Pop() {}
+    void StalePop() {}
+    void DecreaseKey() {}
+    void Pass() {}
+    void Merge(const EngineStats &) {}
+    void Print(std::ostream &) const {}
+    StatCounters Counters(StatCounters extra = {}) const { return extra; }
+};
+
+template<>
+class EngineStats<true> {
+public:
+    void Relax() { ++relaxations; }
+    void Relax(long long count) { relaxations += count; }
+    void Improve() { ++improvements; }
+    void Push() { ++pushes; }
+    void Pop() { ++pops; }
+    void StalePop() { ++stalePops; }
+    void DecreaseKey() { ++decreaseKeys; }
+    void Pass() { ++passes; }
+
+    // Adds the counts of another instance, e.g. one per thread.
+    void Merge(const EngineStats &o) {
+        relaxations += o.relaxations;
+        improvements += o.improvements;
+        pushes += o.pushes;
+        pops += o.pops;
+        stalePops += o.stalePops;
+        decreaseKeys += o.decreaseKeys;
+        passes += o.passes;
+    }
+
+    void Print(std::ostream &out) const {
+        out << "Relaxations = " << relaxations << " attempted, " << improvements << " successful; queue pushes = "
+            << pushes << ", pops = " << pops << " (" << stalePops << " stale); decrease-keys = " << decreaseKeys
+            << "; passes = " << passes << '\n';
+    }
+
+    StatCounters Counters(StatCounters extra = {}) const {
+        extra.insert(extra.end(), {{"relaxations", (double)relaxations}, {"improvements", (double)improvements},
+                                   {"pushes", (double)pushes}, {"pops", (double)pops},
+                                   {"stale_pops", (double)stalePops}, {"decrease_keys", (double)decreaseKeys},
+                                   {"passes", (double)passes}});
+        return extra;
+    }
+
+    long long relaxations = 0, improvements = 0, pushes = 0, pops = 0, stalePops = 0, decreaseKeys = 0, passes = 0;
+};
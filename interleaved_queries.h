@@ -0,0 +1,143 @@
+/* [Description]
+ * This header contains a batch executor for point-to-point queries that hides memory latency by interleaving
+ * several independent Dijkstra searches on one thread with C++20 coroutines.
+ * On a graph much larger than the last-level cache almost every step of a search is a cache miss: the visited
+ * stamp of the popped vertex, its row in the CSR offsets, the start of its edge list and the distance entry of
+ * every neighbor. A single search cannot overlap them, because each depends on the one before. Here every
+ * search is a coroutine (a "lane") that issues a software prefetch for the data it needs next and then
+ * suspends; the scheduler resumes the other lanes round-robin, so by the time a lane comes back its line has
+ * arrived and up to one miss per lane is in flight at once.
+ * - A lane drops stale heap entries without suspending, and suspends only before relaxing a chunk of at least
+ *   INTERLEAVE_MIN_CHUNK neighbors (after prefetching their distance entries); shorter chunks are relaxed at
+ *   once, because a suspension costs more than their few misses. Chunks keep the number of outstanding
+ *   prefetches within what the core can track, even for vertices of high degree.
+ * - Each lane owns a SearchWorkspace and takes the next unanswered query when it finishes one, so the
+ *   workspaces are reused across the whole batch and the queries need not have similar lengths.
+ * The searches read the CSR arrays directly (contiguous edge ranges are what make chunked prefetching possible),
+ * so the executor is specific to CSRGraph; with one lane it is an ordinary Dijkstra plus the cost of the
+ * suspensions. The answers are those of DistanceQueries() (search_workspace.h).
+ * Measured (InterleavedQueryBenchmark, one core with a 300 MiB L3), the executor does not beat the sequential
+ * CSR search: 0.6x at 1 lane and 0.4x at 32 lanes on N10000 D0.1, 1.0x at 1 lane and 0.6x at 32 lanes on
+ * N300000 D0.00006, 0.9x at 1 to 8 lanes on N4000000 D0.000005 (40M edges, beyond the L3). Most misses of a
+ * search are in the binary heap, which no prefetch of a lane covers, and every lane adds its own workspace and
+ * heap to the working set, so more lanes are slower.
+ *
+ * Libraries:
+ * - coroutine, exception: The lane coroutines and their promise type.
+ * - vector, utility, algorithm: Queries, lanes and answers.
+ * - graph_csr.h: The graph.
+ * - search_workspace.h: Per-lane workspace with its binary heap.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+#include "graph_csr.h"
+#include "search_workspace.h"
+
+// A coroutine that runs until it is done, suspending at every co_await PrefetchYield{}. Starts suspended.
+class QueryLane {
+public:
+    struct promise_type {
+        QueryLane get_return_object() { return QueryLane(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit QueryLane(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    QueryLane(QueryLane &&o) noexcept : handle_(std::exchange(o.handle_, {})) {}
+    QueryLane(const QueryLane &) = delete;
+    QueryLane &operator=(const QueryLane &) = delete;
+    ~QueryLane() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool Done() const { return handle_.done(); }
+    void Resume() { handle_.resume(); }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Suspends the lane so the others can run while its prefetches are in flight.
+struct PrefetchYield {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+// Neighbors whose distance entries are prefetched together before the lane suspends.
+constexpr int INTERLEAVE_CHUNK = 16;
+// The shortest chunk worth a suspension.
+constexpr int INTERLEAVE_MIN_CHUNK = 8;
+
+/* One lane: answers queries[next], queries[next + ...] until the batch is exhausted. next is shared by all lanes
+ * of the batch; they run on one thread, so it needs no synchronization.
+ */
+template<typename Answers>
+QueryLane DijkstraLane(const CSRGraph &g, const std::vector<std::pair<int, int>> &queries, size_t &next,
+                       SearchWorkspace &ws, Answers &answers) {
+    while (next < queries.size()) {
+        size_t q = next++;
+        auto [source, target] = queries[q];
+        ws.Reset();
+        ws.SetDist(source, 0, -1);
+        ws.Push(0, source);
+        while (!ws.HeapEmpty()) {
+            auto [du, x] = ws.Pop();
+            // A stale duplicate is dropped before anything is prefetched: suspending for it only costs time.
+            if (du > ws.Dist(x) || ws.Visited(x)) continue;
+            ws.MarkVisited(x);
+            if (x == target) break;
+
+            int begin = g.offsets[x], end = g.offsets[x + 1];
+            for (int i = begin; i < end; i += INTERLEAVE_CHUNK) {
+                int stop = std::min(end, i + INTERLEAVE_CHUNK);
+                // Short chunks are relaxed at once; their few misses do not pay for a suspension.
+                if (stop - i >= INTERLEAVE_MIN_CHUNK) {
+                    for (int j = i; j < stop; ++j) ws.PrefetchDist(g.targets[j]);
+                    co_await PrefetchYield{};
+                }
+                for (int j = i; j < stop; ++j) {
+                    int y = g.targets[j];
+                    long long nd = du + g.weights[j];
+                    if (nd < ws.Dist(y)) {
+                        ws.SetDist(y, nd, x);
+                        ws.Push(nd, y);
+                    }
+                }
+            }
+        }
+        answers[q] = ws.Dist(target);
+    }
+}
+
+/* Answers a batch of point-to-point queries with one lane per workspace (workspaces.size() searches in flight),
+ * returning INF for unreachable targets. answers is resized to the number of queries; like the workspaces it
+ * keeps its storage between batches.
+ */
+template<typename Answers>
+void InterleavedDistanceQueries(const CSRGraph &g, const std::vector<std::pair<int, int>> &queries,
+                                std::vector<SearchWorkspace> &workspaces, Answers &answers) {
+    answers.resize(queries.size());
+    size_t next = 0;
+    std::vector<QueryLane> lanes;
+    lanes.reserve(workspaces.size());
+    for (SearchWorkspace &ws : workspaces) lanes.push_back(DijkstraLane(g, queries, next, ws, answers));
+    for (size_t running = lanes.size(); running > 0;) {
+        running = 0;
+        for (QueryLane &lane : lanes) {
+            if (lane.Done()) continue;
+            lane.Resume();
+            running += !lane.Done();
+        }
+    }
+}
@@ -0,0 +1,371 @@
+/* [Description]
+ * This header contains the vertex potentials used by Johnson's algorithm and their incremental maintenance.
+ * A potential h is feasible when every edge keeps a non-negative reduced cost w(u, v) + h[u] - h[v]; Dijkstra
+ * can then run on the reduced costs and the true distance is d_h(s, t) - h[s] + h[t].
+ * - ComputePotentials: the from-scratch computation, all with the virtual source joined to every vertex by 0:
+ *   - BellmanFord: full sweeps over all edges until nothing changes, O(N * M).
+ *   - SPFA: only vertices whose potential changed are scanned again (FIFO queue, as in SPFA.cpp).
+ *   - SLF: SPFA with the small-label-first deque of SPFADeque.cpp.
+ *   - GoldbergRadzik: passes that scan the vertices reachable over negative reduced costs in topological order,
+ *     which usually needs far fewer scans than SPFA on graphs with long negative chains.
+ *   - DAG: one relaxation sweep in topological order, O(N + M); only applicable if the graph is acyclic.
+ *   - Auto: DAG when the graph is acyclic, Goldberg-Radzik otherwise.
+ *   All of them are O(N * M) in the worst case and report negative cycles; they differ only in practice.
+ * - ReducedGraph: a view that presents any graph with reduced costs, so the generic Dijkstra runs on it directly.
+ * - PotentialRepair: keeps h feasible while the graph changes. Deleting an edge or raising its weight can only
+ *   raise reduced costs, so nothing has to be done. When (u, v) is inserted or lowered and its reduced cost
+ *   becomes -delta < 0, a Dijkstra from v over the (non-negative) reduced costs finds every vertex x closer
+ *   than delta, and h[x] -= delta - d(x) makes all edges non-negative again. Only the region within delta of v
+ *   is touched. If that search reaches u, the new edge closes a negative cycle; in that case the repair falls
+ *   back to a full recomputation, which confirms the cycle.
+ *
+ * Libraries:
+ * - vector, deque, algorithm, utility: Potentials, the SPFA queues, changed edges and the touched vertices of a repair.
+ * - graph_csr.h: Edge.
+ * - engine_stats.h: Optional work counters for the from-scratch methods.
+ * - search_workspace.h: The generation-stamped workspace and the generic Dijkstra.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "engine_stats.h"
+#include "graph_csr.h"
+#include "search_workspace.h"
+
+/* Computes feasible potentials as distances from a virtual source joined to every vertex with weight 0.
+ * Returns false if the graph has a negative cycle. Like every method below, it counts its work in stats
+ * (engine_stats.h); the overloads without stats count nothing.
+ */
+template<typename Graph, bool CollectStats>
+bool BellmanFordPotentials(const Graph &g, std::vector<long long> &h, EngineStats<CollectStats> &stats) {
+    int n = VertexCount(g);
+    h.assign(n, 0);
+    for (int round = 0; round <= n; ++round) {
+        stats.Pass();
+        bool updated = false;
+        for (int u = 0; u < n; ++u) {
+            ForEachNeighbor(g, u, [&](int v, long long w) {
+                stats.Relax();
+                if (h[u] + w < h[v]) {
+                    h[v] = h[u] + w;
+                    stats.Improve();
+                    updated = true;
+                }
+            });
+        }
+        if (!updated) return true;
+    }
+    return false;
+}
+
+template<typename Graph>
+bool BellmanFordPotentials(const Graph &g, std::vector<long long> &h) {
+    EngineStats<false> none;
+    return BellmanFordPotentials(g, h, none);
+}
+
+// True if the parent pointers (the last improving edge into each vertex) form a cycle, which can only be a
+// negative one. O(n); walk is scratch space of n entries that must start out as zeros.
+inline bool ParentGraphHasCycle(const std::vector<int> &parent, std::vector<int> &walk) {
+    int n = (int)parent.size();
+    bool cycle = false;
+    for (int start = 0; start < n && !cycle; ++start) {
+        int x = start;
+        while (x != -1 && walk[x] == 0) {
+            walk[x] = start + 1;
+            x = parent[x];
+        }
+        cycle = (x != -1 && walk[x] == start + 1);
+    }
+    std::fill(walk.begin(), walk.end(), 0);
+    return cycle;
+}
+
+// Queue-based Bellman-Ford. SLF pushes a vertex to the front if its potential is below the front's.
+// Counting enqueues per vertex does not bound SLF, so cycles are found by checking the parent pointers every n
+// improvements instead, which costs O(n) per O(n) work.
+template<typename Graph, bool CollectStats>
+bool SPFAPotentials(const Graph &g, std::vector<long long> &h, bool smallLabelFirst, EngineStats<CollectStats> &stats) {
+    int n = VertexCount(g);
+    h.assign(n, 0);
+    std::vector<char> inQueue(n, 1);
+    std::vector<int> parent(n, -1), walk(n, 0);
+    std::deque<int> queue;
+    for (int u = 0; u < n; ++u) {
+        queue.push_back(u);
+        stats.Push();
+    }
+    long long improvements = 0;
+    while (!queue.empty()) {
+        int u = queue.front();
+        queue.pop_front();
+        stats.Pop();
+        inQueue[u] = 0;
+        ForEachNeighbor(g, u, [&](int v, long long w) {
+            stats.Relax();
+            if (h[u] + w >= h[v]) return;
+            h[v] = h[u] + w;
+            parent[v] = u;
+            stats.Improve();
+            ++improvements;
+            if (inQueue[v]) return;
+            if (smallLabelFirst && !queue.empty() && h[v] < h[queue.front()]) queue.push_front(v);
+            else queue.push_back(v);
+            stats.Push();
+            inQueue[v] = 1;
+        });
+        if (improvements >= n) {
+            improvements = 0;
+            if (ParentGraphHasCycle(parent, walk)) return false;
+        }
+    }
+    return true;
+}
+
+template<typename Graph>
+bool SPFAPotentials(const Graph &g, std::vector<long long> &h, bool smallLabelFirst) {
+    EngineStats<false> none;
+    return SPFAPotentials(g, h, smallLabelFirst, none);
+}
+
+/* Goldberg-Radzik: each pass takes the vertices whose potential changed in the previous pass and that still
+ * have an edge with negative reduced cost, collects everything reachable from them over such edges by DFS and
+ * scans it in topological order. A pass does at least the work of one Bellman-Ford round on the changed
+ * vertices, so more than n passes means a negative cycle; so does a DFS back edge, since it closes a cycle of
+ * negative reduced costs. Waiting for n passes would be far too slow, so after each pass the graph of last
+ * improving edges (parent pointers) is also checked for a cycle, which can only be a negative one, in O(n).
+ */
+template<typename Graph, bool CollectStats>
+bool GoldbergRadzikPotentials(const Graph &g, std::vector<long long> &h, EngineStats<CollectStats> &stats) {
+    int n = VertexCount(g);
+    h.assign(n, 0);
+    std::vector<int> changed(n), order, children, parent(n, -1), walk(n, 0);
+    for (int u = 0; u < n; ++u) changed[u] = u;
+    std::vector<char> state(n, 0), inChanged(n, 1);   // state: 0 = unseen, 1 = on the DFS stack, 2 = done
+    struct Frame { int vertex; size_t begin, next, end; };  // children[next, end) are still to be visited
+    std::vector<Frame> dfs;
+    bool cycle = false;
+    auto enter = [&](int x) {
+        state[x] = 1;
+        size_t begin = children.size();
+        ForEachNeighbor(g, x, [&](int v, long long w) {
+            stats.Relax();
+            if (h[x] + w >= h[v]) return;
+            if (state[v] == 1) cycle = true;
+            else if (state[v] == 0) children.push_back(v);
+        });
+        dfs.push_back({x, begin, begin, children.size()});
+    };
+
+    for (int pass = 0; !changed.empty(); ++pass) {
+        if (pass > n) return false;
+        stats.Pass();
+        order.clear();
+        for (int root : changed) {
+            inChanged[root] = 0;
+            if (state[root]) continue;
+            bool improving = false;
+            ForEachNeighbor(g, root, [&](int v, long long w) {
+                stats.Relax();
+                improving |= (h[root] + w < h[v]);
+            });
+            if (!improving) continue;
+            enter(root);
+            while (!dfs.empty() && !cycle) {
+                Frame &f = dfs.back();
+                if (f.next == f.end) {
+                    state[f.vertex] = 2;
+                    order.push_back(f.vertex);
+                    children.resize(f.begin);
+                    dfs.pop_back();
+                    continue;
+                }
+                int child = children[f.next++];
+                if (state[child] == 0) enter(child);
+            }
+            if (cycle) return false;
+        }
+        changed.clear();
+        // order is a DFS postorder, so walking it backwards scans every vertex before its successors.
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int u = *it;
+            state[u] = 0;
+            ForEachNeighbor(g, u, [&](int v, long long w) {
+                stats.Relax();
+                if (h[u] + w < h[v]) {
+                    h[v] = h[u] + w;
+                    parent[v] = u;
+                    stats.Improve();
+                    if (!inChanged[v]) {
+                        inChanged[v] = 1;
+                        changed.push_back(v);
+                    }
+                }
+            });
+        }
+        if (ParentGraphHasCycle(parent, walk)) return false;
+    }
+    return true;
+}
+
+template<typename Graph>
+bool GoldbergRadzikPotentials(const Graph &g, std::vector<long long> &h) {
+    EngineStats<false> none;
+    return GoldbergRadzikPotentials(g, h, none);
+}
+
+// One sweep in topological order (Kahn). Returns false if the graph has a cycle, leaving h unspecified.
+template<typename Graph, bool CollectStats>
+bool DAGPotentials(const Graph &g, std::vector<long long> &h, EngineStats<CollectStats> &stats) {
+    int n = VertexCount(g);
+    std::vector<int> indegree(n, 0), order;
+    order.reserve(n);
+    for (int u = 0; u < n; ++u) ForEachNeighbor(g, u, [&](int v, long long) { ++indegree[v]; });
+    for (int u = 0; u < n; ++u)
+        if (indegree[u] == 0) order.push_back(u);
+    for (size_t i = 0; i < order.size(); ++i)
+        ForEachNeighbor(g, order[i], [&](int v, long long) { if (--indegree[v] == 0) order.push_back(v); });
+    if ((int)order.size() != n) return false;
+    h.assign(n, 0);
+    stats.Pass();
+    for (int u : order) {
+        ForEachNeighbor(g, u, [&](int v, long long w) {
+            stats.Relax();
+            if (h[u] + w < h[v]) {
+                h[v] = h[u] + w;
+                stats.Improve();
+            }
+        });
+    }
+    return true;
+}
+
+template<typename Graph>
+bool DAGPotentials(const Graph &g, std::vector<long long> &h) {
+    EngineStats<false> none;
+    return DAGPotentials(g, h, none);
+}
+
+enum class PotentialMethod { BellmanFord, SPFA, SLF, GoldbergRadzik, DAG, Auto };
+
+inline const char *PotentialMethodName(PotentialMethod method) {
+    switch (method) {
+        case PotentialMethod::BellmanFord: return "Bellman-Ford";
+        case PotentialMethod::SPFA: return "SPFA";
+        case PotentialMethod::SLF: return "SPFA (SLF)";
+        case PotentialMethod::GoldbergRadzik: return "Goldberg-Radzik";
+        case PotentialMethod::DAG: return "DAG";
+        default: return "Auto";
+    }
+}
+
+/* Computes feasible potentials with the given method. Returns false if the graph has a negative cycle, or, for
+ * DAG, if the graph is not acyclic. If used is given, it receives the method that actually ran. The work is
+ * counted in stats, including a DAG sweep tried by Auto on a graph that turns out to be cyclic.
+ */
+template<typename Graph, bool CollectStats>
+bool ComputePotentials(const Graph &g, std::vector<long long> &h, PotentialMethod method, PotentialMethod *used,
+                       EngineStats<CollectStats> &stats) {
+    bool acyclic = (method == PotentialMethod::Auto || method == PotentialMethod::DAG) && DAGPotentials(g, h, stats);
+    if (method == PotentialMethod::Auto) method = acyclic ? PotentialMethod::DAG : PotentialMethod::GoldbergRadzik;
+    if (used) *used = method;
+    if (method == PotentialMethod::DAG) return acyclic;
+    switch (method) {
+        case PotentialMethod::BellmanFord: return BellmanFordPotentials(g, h, stats);
+        case PotentialMethod::SPFA: return SPFAPotentials(g, h, false, stats);
+        case PotentialMethod::SLF: return SPFAPotentials(g, h, true, stats);
+        case PotentialMethod::GoldbergRadzik: return GoldbergRadzikPotentials(g, h, stats);
+        default: return true;
+    }
+}
+
+template<typename Graph>
+bool ComputePotentials(const Graph &g, std::vector<long long> &h, PotentialMethod method = PotentialMethod::Auto,
+                       PotentialMethod *used = nullptr) {
+    EngineStats<false> none;
+    return ComputePotentials(g, h, method, used, none);
+}
+
+// The graph g with every weight replaced by its reduced cost under h.
+template<typename Graph>
+struct ReducedGraph {
+    const Graph &g;
+    const std::vector<long long> &h;
+};
+
+template<typename Graph, typename F>
+inline void ForEachNeighbor(const ReducedGraph<Graph> &r, int u, F &&f) {
+    long long hu = r.h[u];
+    ForEachNeighbor(r.g, u, [&](int v, long long w) { f(v, w + hu - r.h[v]); });
+}
+
+template<typename Graph>
+inline int VertexCount(const ReducedGraph<Graph> &r) { return VertexCount(r.g); }
+
+class PotentialRepair {
+public:
+    explicit PotentialRepair(int vertexCount = 0) : ws_(vertexCount) {}
+
+    long long LastTouched() const { return lastTouched_; }
+    int Fallbacks() const { return fallbacks_; }
+
+    /* Restores feasibility of h after the edges in changed were inserted into g or had their weight lowered
+     * (g already holds the new weights). Returns false if g now has a negative cycle.
+     */
+    template<typename Graph>
+    bool Repair(const Graph &g, std::vector<long long> &h, const std::vector<Edge> &changed) {
+        lastTouched_ = 0;
+        if (ws_.VertexCount() < VertexCount(g)) ws_.Resize(VertexCount(g));
+        for (const Edge &e : changed) {
+            if (!RepairEdge(g, h, e)) {
+                ++fallbacks_;
+                return ComputePotentials(g, h);
+            }
+        }
+        return true;
+    }
+
+private:
+    SearchWorkspace ws_;
+    std::vector<std::pair<int, long long>> touched_;
+    long long lastTouched_ = 0;
+    int fallbacks_ = 0;
+
+    /* Edges whose reduced cost is still negative belong to changes that are not repaired yet; the search skips
+     * them, so each step only relies on edges that are already feasible and never makes one of them negative.
+     */
+    template<typename Graph>
+    bool RepairEdge(const Graph &g, std::vector<long long> &h, const Edge &e) {
+        long long delta = h[e.to] - h[e.from] - e.weight;
+        if (delta <= 0) return true;
+        touched_.clear();
+        ws_.Reset();
+        ws_.SetDist(e.to, 0, -1);
+        ws_.Push(0, e.to);
+        while (!ws_.HeapEmpty()) {
+            auto [d, x] = ws_.Pop();
+            if (d >= delta) break;
+            if (ws_.Visited(x)) continue;
+            ws_.MarkVisited(x);
+            if (x == e.from) return false;
+            touched_.emplace_back(x, d);
+            ForEachNeighbor(g, x, [&, d = d, x = x](int y, long long w) {
+                long long reduced = w + h[x] - h[y];
+                if (reduced < 0) return;
+                if (d + reduced < ws_.Dist(y)) {
+                    ws_.SetDist(y, d + reduced, x);
+                    ws_.Push(d + reduced, y);
+                }
+            });
+        }
+        for (auto [x, d] : touched_) h[x] -= delta - d;
+        lastTouched_ += (long long)touched_.size();
+        return true;
+    }
+};
@@ -0,0 +1,211 @@
+/* [Description]
+ * This header contains the memory instrumentation shared by the programs in this repository. It replaces the
+ * old PrintMemoryUsage(), which scraped VmPeak/VmRSS from /proc/self/status: those are process-wide page
+ * counts, include the stdio/ifstream buffers and the reserved address space, and cannot tell phases apart.
+ * - The global operator new/delete are replaced with versions that count allocations, allocated bytes and the
+ *   live heap (via malloc_usable_size), keeping its peak. Include the header in exactly one translation unit
+ *   of a program (the programs here are single-file).
+ * - Phases: BeginMemoryPhase("name") ... EndMemoryPhase() records the wall time, allocations, bytes and the peak
+ *   live heap of that stretch of the program; starting a phase ends the previous one. MemoryPhaseRecords()
+ *   returns them, e.g. for bench_report.h.
+ * - Structures: TrackStructure("name", bytes) records the size of one data structure (graph, heap, distance
+ *   arrays). This also covers memory that bypasses operator new, e.g. the mmap-backed arrays of numa_alloc.h.
+ * - PrintMemoryUsage() prints the current counters plus the maximum resident set size (getrusage), and
+ *   PrintMemoryReport() the phase and structure tables.
+ * The older AllocationCounts()/AllocationSnapshot interface is kept for measuring a stretch by hand.
+ *
+ * Libraries:
+ * - atomic, cstddef, cstdlib, new, malloc.h: The counting allocator.
+ * - iostream, string, vector, mutex, chrono: Phase and structure records, phase timing and the output.
+ * - sys/resource.h: Maximum resident set size.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace memory_stats_internal {
+inline std::atomic<long long> allocations{0}, bytes{0}, live{0}, peak{0}, highWater{0};
+
+inline void *Allocate(std::size_t size, std::size_t alignment) {
+    void *p = alignment <= alignof(std::max_align_t)
+                  ? std::malloc(size ? size : 1)
+                  : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!p) throw std::bad_alloc();
+    long long usable = (long long)malloc_usable_size(p);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add((long long)size, std::memory_order_relaxed);
+    long long now = live.fetch_add(usable, std::memory_order_relaxed) + usable;
+    long long seen = peak.load(std::memory_order_relaxed);
+    while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    seen = highWater.load(std::memory_order_relaxed);
+    while (now > seen && !highWater.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    return p;
+}
+
+inline void Free(void *p) {
+    if (!p) return;
+    live.fetch_sub((long long)malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+struct PhaseRecord {
+    std::string name;
+    long long allocations, bytes, liveAtStart, peak;
+    std::chrono::steady_clock::time_point start;
+    long long ns;
+    bool open;
+};
+
+struct Registry {
+    std::mutex lock;
+    std::vector<PhaseRecord> phases;
+    std::vector<std::pair<std::string, long long>> structures;
+};
+
+inline Registry &GetRegistry() {
+    static Registry *registry = new Registry();   // never destroyed, so it outlives every static that allocates
+    return *registry;
+}
+} // namespace memory_stats_internal
+
+struct AllocationSnapshot {
+    long long allocations = 0, bytes = 0;
+
+    AllocationSnapshot operator-(const AllocationSnapshot &o) const {
+        return {allocations - o.allocations, bytes - o.bytes};
+    }
+};
+
+// Allocations and bytes requested from operator new since the program started.
+inline AllocationSnapshot AllocationCounts() {
+    return {memory_stats_internal::allocations.load(std::memory_order_relaxed),
+            memory_stats_internal::bytes.load(std::memory_order_relaxed)};
+}
+
+inline long long LiveHeapBytes() { return memory_stats_internal::live.load(std::memory_order_relaxed); }
+inline long long PeakHeapBytes() { return memory_stats_internal::peak.load(std::memory_order_relaxed); }
+// The largest live heap since the program started (PeakHeapBytes() restarts with every phase).
+inline long long MaxHeapBytes() { return memory_stats_internal::highWater.load(std::memory_order_relaxed); }
+
+// Bytes held by a vector (its capacity) and by a vector of vectors (including the inner ones).
+template<typename V>
+long long VectorBytes(const V &v) { return (long long)(v.capacity() * sizeof(typename V::value_type)); }
+
+template<typename V>
+long long NestedVectorBytes(const V &v) {
+    long long total = VectorBytes(v);
+    for (const auto &inner : v) total += VectorBytes(inner);
+    return total;
+}
+
+/* Bytes held by a std::priority_queue: the capacity of its container, which never shrinks, so read once after
+ * the search it is the footprint at the largest queue size without any bookkeeping inside the loop.
+ */
+template<typename Q>
+long long PriorityQueueBytes(const Q &q) {
+    struct Access : Q {
+        static long long Bytes(const Q &queue) { return VectorBytes(queue.*&Access::c); }
+    };
+    return Access::Bytes(q);
+}
+
+inline void EndMemoryPhase() {
+    using namespace memory_stats_internal;
+    Registry &r = GetRegistry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (r.phases.empty() || !r.phases.back().open) return;
+    PhaseRecord &p = r.phases.back();
+    AllocationSnapshot now = AllocationCounts();
+    p.allocations = now.allocations - p.allocations;
+    p.bytes = now.bytes - p.bytes;
+    p.peak = PeakHeapBytes() - p.liveAtStart;
+    p.ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - p.start).count();
+    p.open = false;
+}
+
+// Ends the running phase, if any, and starts a new one. The peak is measured relative to the heap at its start.
+inline void BeginMemoryPhase(const std::string &name) {
+    using namespace memory_stats_internal;
+    EndMemoryPhase();
+    Registry &r = GetRegistry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.phases.reserve(16);
+    long long liveNow = LiveHeapBytes();
+    peak.store(liveNow, std::memory_order_relaxed);
+    AllocationSnapshot now = AllocationCounts();
+    r.phases.push_back({name, now.allocations, now.bytes, liveNow, 0, std::chrono::steady_clock::now(), 0, true});
+}
+
+struct MemoryPhaseStats {
+    std::string name;
+    long long ns, allocations, bytes, peakBytes;
+};
+
+// The finished phases so far, in order.
+inline std::vector<MemoryPhaseStats> MemoryPhaseRecords() {
+    memory_stats_internal::Registry &r = memory_stats_internal::GetRegistry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    std::vector<MemoryPhaseStats> out;
+    for (const auto &p : r.phases)
+        if (!p.open) out.push_back({p.name, p.ns, p.allocations, p.bytes, p.peak});
+    return out;
+}
+
+inline void TrackStructure(const std::string &name, long long bytes) {
+    memory_stats_internal::Registry &r = memory_stats_internal::GetRegistry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.structures.emplace_back(name, bytes);
+}
+
+// Current heap counters and the largest resident set so far.
+inline void PrintMemoryUsage() {
+    AllocationSnapshot total = AllocationCounts();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "Heap: " << total.allocations << " allocations, " << total.bytes << " bytes allocated, "
+              << LiveHeapBytes() << " bytes live\n";
+    std::cout << "Max RSS: " << usage.ru_maxrss << " kB\n";
+}
+
+// The phase and structure tables recorded so far.
+inline void PrintMemoryReport() {
+    EndMemoryPhase();
+    memory_stats_internal::Registry &r = memory_stats_internal::GetRegistry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (!r.phases.empty()) std::cout << "Memory by phase:\n";
+    for (const auto &p : r.phases)
+        std::cout << "  " << p.name << ": " << p.ns << " ns, " << p.allocations << " allocations, " << p.bytes
+                  << " bytes allocated, peak heap +" << p.peak << " bytes\n";
+    if (!r.structures.empty()) std::cout << "Memory by structure:\n";
+    for (const auto &[name, bytes] : r.structures) std::cout << "  " << name << " = " << bytes << " bytes\n";
+}
+
+void *operator new(std::size_t size) { return memory_stats_internal::Allocate(size, 0); }
+void *operator new[](std::size_t size) { return memory_stats_internal::Allocate(size, 0); }
+void *operator new(std::size_t size, std::align_val_t a) {
+    return memory_stats_internal::Allocate(size, (std::size_t)a);
+}
+void *operator new[](std::size_t size, std::align_val_t a) {
+    return memory_stats_internal::Allocate(size, (std::size_t)a);
+}
+void operator delete(void *p) noexcept { memory_stats_internal::Free(p); }
+void operator delete[](void *p) noexcept { memory_stats_internal::Free(p); }
+void operator delete(void *p, std::size_t) noexcept { memory_stats_internal::Free(p); }
+void operator delete[](void *p, std::size_t) noexcept { memory_stats_internal::Free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { memory_stats_internal::Free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { memory_stats_internal::Free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { memory_stats_internal::Free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { memory_stats_internal::Free(p); }
@@ -0,0 +1,325 @@
+/* [Description]
+ * This header implements a (min,+) matrix product library and the all-pairs shortest path engines built on
+ * it. Distances are stored in a contiguous, padded, row-major matrix of 32-bit integers (DistanceMatrix);
+ * sub-blocks of it are addressed through MatrixView without copying.
+ * The product C = min(C, A (x) B) is computed like a GEMM: the loops are blocked for the caches and the
+ * innermost 4x16 tile of C is kept in registers while a strip of A and B streams past it (AVX2 micro-kernel,
+ * chosen at runtime, with a portable fallback). Large products are split between threads.
+ * On top of the product the header provides repeated-squaring APSP, a blocked Floyd-Warshall and the
+ * recursive, cache-oblivious R-Kleene algorithm.
+ *
+ * The matrix lives on a LargeArray (numa_alloc.h): huge pages and NUMA interleaving follow GRAPH_MEMORY, and
+ * otherwise it is first-touched in parallel.
+ *
+ * Conventions:
+ * - MATRIX_INF marks "no path". A + B never overflows because MATRIX_INF + MATRIX_INF < 2^31; with negative
+ *   weights an unreachable entry can drift slightly below MATRIX_INF, so anything above MATRIX_INF / 2 is
+ *   treated as unreachable and NormalizeInfinity() restores the exact value at the end of each engine.
+ * - The padded size is a multiple of MATRIX_TILE in both dimensions; padding entries are MATRIX_INF so they
+ *   never create a path. All views handed to the kernels are multiples of MATRIX_TILE in size.
+ * - An output view may alias one of its inputs (C == A or C == B). This is what the Floyd-Warshall style
+ *   updates need; values only ever decrease to lengths of real paths, so reading a freshly updated value is
+ *   harmless, and the threads are split along the dimension that keeps the aliased data private.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <immintrin.h>
+#include "numa_alloc.h"
+
+const int32_t MATRIX_INF = 1 << 29;
+const int MATRIX_TILE = 16;
+
+struct MatrixView {
+    int32_t *data;
+    int rows, cols;
+    size_t stride;
+
+    int32_t &at(int i, int j) const { return data[(size_t)i * stride + j]; }
+    MatrixView Block(int r0, int c0, int r, int c) const {
+        return {data + (size_t)r0 * stride + c0, r, c, stride};
+    }
+};
+
+class DistanceMatrix {
+public:
+    explicit DistanceMatrix(int n = 0)
+        : n_(n), padded_((n + MATRIX_TILE - 1) / MATRIX_TILE * MATRIX_TILE),
+          data_((size_t)padded_ * padded_) {
+        // First touch in contiguous row blocks, one per thread, like the products split their rows, so that
+        // without GRAPH_MEMORY=interleave each block lands on the NUMA node of the thread that computes it.
+        data_.ParallelFill(MATRIX_INF);
+        for (int i = 0; i < n_; ++i) at(i, i) = 0;
+    }
+
+    int Size() const { return n_; }
+    int PaddedSize() const { return padded_; }
+    size_t Bytes() const { return data_.size() * sizeof(int32_t); }
+
+    int32_t &at(int i, int j) { return data_[(size_t)i * padded_ + j]; }
+    int32_t at(int i, int j) const { return data_[(size_t)i * padded_ + j]; }
+    int32_t *Row(int i) { return data_.data() + (size_t)i * padded_; }
+    MatrixView View() { return {data_.data(), padded_, padded_, (size_t)padded_}; }
+
+    bool operator==(const DistanceMatrix &o) const { return n_ == o.n_ && data_ == o.data_; }
+
+private:
+    int n_, padded_;
+    LargeArray<int32_t> data_;
+};
+
+namespace min_plus_internal {
+
+const int MR = 4, NR = 16;          // register tile of C
+const int KC = 256, MC = 64, NC = 512; // cache blocks
+
+inline void MicroKernelScalar(const int32_t *A, size_t lda, const int32_t *B, size_t ldb,
+                              int32_t *C, size_t ldc, int kc) {
+    int32_t c[MR][NR];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j) c[i][j] = C[i * ldc + j];
+    for (int k = 0; k < kc; ++k) {
+        const int32_t *b = B + (size_t)k * ldb;
+        for (int i = 0; i < MR; ++i) {
+            int32_t a = A[i * lda + k];
+            for (int j = 0; j < NR; ++j) c[i][j] = std::min(c[i][j], a + b[j]);
+        }
+    }
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j) C[i * ldc + j] = c[i][j];
+}
+
+__attribute__((target("avx2")))
+inline void MicroKernelAVX2(const int32_t *A, size_t lda, const int32_t *B, size_t ldb,
+                            int32_t *C, size_t ldc, int kc) {
+    __m256i c[MR][2];
+    for (int i = 0; i < MR; ++i) {
+        c[i][0] = _mm256_loadu_si256((const __m256i *)(C + i * ldc));
+        c[i][1] = _mm256_loadu_si256((const __m256i *)(C + i * ldc + 8));
+    }
+    for (int k = 0; k < kc; ++k) {
+        const int32_t *b = B + (size_t)k * ldb;
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)b);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(b + 8));
+        for (int i = 0; i < MR; ++i) {
+            __m256i a = _mm256_set1_epi32(A[i * lda + k]);
+            c[i][0] = _mm256_min_epi32(c[i][0], _mm256_add_epi32(a, b0));
+            c[i][1] = _mm256_min_epi32(c[i][1], _mm256_add_epi32(a, b1));
+        }
+    }
+    for (int i = 0; i < MR; ++i) {
+        _mm256_storeu_si256((__m256i *)(C + i * ldc), c[i][0]);
+        _mm256_storeu_si256((__m256i *)(C + i * ldc + 8), c[i][1]);
+    }
+}
+
+// Single-threaded blocked product on a rows x cols part of C.
+template<bool UseAVX2>
+void MultiplyBlock(MatrixView C, MatrixView A, MatrixView B) {
+    for (int jc = 0; jc < C.cols; jc += NC) {
+        int nc = std::min(NC, C.cols - jc);
+        for (int pc = 0; pc < A.cols; pc += KC) {
+            int kc = std::min(KC, A.cols - pc);
+            for (int ic = 0; ic < C.rows; ic += MC) {
+                int mc = std::min(MC, C.rows - ic);
+                for (int jr = 0; jr < nc; jr += NR) {
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        const int32_t *a = &A.at(ic + ir, pc);
+                        const int32_t *b = &B.at(pc, jc + jr);
+                        int32_t *c = &C.at(ic + ir, jc + jr);
+                        if (UseAVX2) MicroKernelAVX2(a, A.stride, b, B.stride, c, C.stride, kc);
+                        else MicroKernelScalar(a, A.stride, b, B.stride, c, C.stride, kc);
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline bool HasAVX2() {
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+}
+
+inline int DefaultThreads() {
+    static const int threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+}
+
+} // namespace min_plus_internal
+
+/* C = min(C, A (x) B) where (A (x) B)[i][j] = min_k A[i][k] + B[k][j].
+ * threads <= 0 uses all hardware threads; small products always run on the calling thread.
+ */
+inline void MinPlusMultiplyAdd(MatrixView C, MatrixView A, MatrixView B, int threads = 0) {
+    using namespace min_plus_internal;
+    if (threads <= 0) threads = DefaultThreads();
+    auto run = [](MatrixView c, MatrixView a, MatrixView b) {
+        if (HasAVX2()) MultiplyBlock<true>(c, a, b);
+        else MultiplyBlock<false>(c, a, b);
+    };
+
+    // When C aliases B, every thread must own whole columns of both; otherwise split the rows of C (and A).
+    bool splitColumns = (C.data == B.data);
+    int units = splitColumns ? C.cols / NR : C.rows / MR;
+    double work = (double)C.rows * C.cols * A.cols;
+    threads = std::min(threads, units);
+    if (threads <= 1 || work < (1 << 22)) {
+        run(C, A, B);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        int from = (int)((long long)units * t / threads), to = (int)((long long)units * (t + 1) / threads);
+        if (from == to) continue;
+        if (splitColumns) {
+            int c0 = from * NR, c1 = to * NR;
+            pool.emplace_back(run, C.Block(0, c0, C.rows, c1 - c0), A, B.Block(0, c0, B.rows, c1 - c0));
+        } else {
+            int r0 = from * MR, r1 = to * MR;
+            pool.emplace_back(run, C.Block(r0, 0, r1 - r0, C.cols), A.Block(r0, 0, r1 - r0, A.cols), B);
+        }
+    }
+    for (auto &t : pool) t.join();
+}
+
+// Classic in-place Floyd-Warshall on a square view; used for diagonal blocks and small matrices.
+inline void FloydWarshallBlock(MatrixView D) {
+    for (int k = 0; k < D.rows; ++k) {
+        const int32_t *dk = &D.at(k, 0);
+        for (int i = 0; i < D.rows; ++i) {
+            int32_t dik = D.at(i, k);
+            if (dik > MATRIX_INF / 2) continue;
+            int32_t *di = &D.at(i, 0);
+            for (int j = 0; j < D.cols; ++j) di[j] = std::min(di[j], dik + dk[j]);
+        }
+    }
+}
+
+// Replaces every drifted "unreachable" value by exactly MATRIX_INF.
+inline void NormalizeInfinity(DistanceMatrix &D) {
+    for (int i = 0; i < D.PaddedSize(); ++i) {
+        int32_t *row = D.Row(i);
+        for (int j = 0; j < D.PaddedSize(); ++j)
+            if (row[j] > MATRIX_INF / 2) row[j] = MATRIX_INF;
+    }
+}
+
+inline bool HasNegativeCycle(const DistanceMatrix &D) {
+    for (int i = 0; i < D.Size(); ++i)
+        if (D.at(i, i) < 0) return true;
+    return false;
+}
+
+/* Blocked Floyd-Warshall: for every diagonal block k, close it with the classic algorithm, update the
+ * block row and block column through it, then update the remaining matrix with one min-plus product.
+ */
+inline void BlockedFloydWarshall(DistanceMatrix &D, int blockSize = 256, int threads = 0) {
+    MatrixView M = D.View();
+    int n = D.PaddedSize();
+    blockSize = std::max(MATRIX_TILE, blockSize / MATRIX_TILE * MATRIX_TILE);
+    for (int k0 = 0; k0 < n; k0 += blockSize) {
+        int b = std::min(blockSize, n - k0), k1 = k0 + b;
+        MatrixView pivot = M.Block(k0, k0, b, b);
+        FloydWarshallBlock(pivot);
+
+        // Block row and block column through the closed pivot, leaving the pivot itself alone.
+        int ranges[2][2] = {{0, k0}, {k1, n}};
+        for (auto &r : ranges) {
+            if (r[0] == r[1]) continue;
+            MatrixView rowPart = M.Block(k0, r[0], b, r[1] - r[0]);
+            MatrixView colPart = M.Block(r[0], k0, r[1] - r[0], b);
+            MinPlusMultiplyAdd(rowPart, pivot, rowPart, threads);
+            MinPlusMultiplyAdd(colPart, colPart, pivot, threads);
+        }
+
+        // The rest of the matrix, skipping the pivot block row and column, in up to four rectangles.
+        for (auto &rr : ranges) {
+            if (rr[0] == rr[1]) continue;
+            for (auto &cr : ranges) {
+                if (cr[0] == cr[1]) continue;
+                MinPlusMultiplyAdd(M.Block(rr[0], cr[0], rr[1] - rr[0], cr[1] - cr[0]),
+                                   M.Block(rr[0], k0, rr[1] - rr[0], b),
+                                   M.Block(k0, cr[0], b, cr[1] - cr[0]), threads);
+            }
+        }
+    }
+    NormalizeInfinity(D);
+}
+
+/* APSP by repeated squaring: after round r the matrix holds shortest paths with at most 2^r edges, so a graph
+ * whose shortest paths have at most H edges converges after ceil(log2 H) + 1 rounds. Stops at the first round
+ * that changes nothing. Returns the number of rounds, or -1 if a negative cycle was found.
+ */
+inline int SquaringAPSP(DistanceMatrix &D, int threads = 0) {
+    DistanceMatrix next = D;
+    int rounds = 0;
+    for (long long hops = 1; ; hops *= 2) {
+        ++rounds;
+        MinPlusMultiplyAdd(next.View(), D.View(), D.View(), threads);
+        NormalizeInfinity(next);
+        if (HasNegativeCycle(next)) return -1;
+        bool changed = !(next == D);
+        std::swap(D, next);
+        if (!changed || hops >= D.Size()) break;
+        std::memcpy(next.Row(0), D.Row(0), D.Bytes());
+    }
+    return rounds;
+}
+
+namespace min_plus_internal {
+
+// Runs two independent updates, on two threads when the budget allows.
+template<class F, class G>
+void RunPair(int threads, F first, G second) {
+    if (threads <= 1) {
+        first(1);
+        second(1);
+        return;
+    }
+    int half = threads / 2;
+    std::thread worker(first, half);
+    second(threads - half);
+    worker.join();
+}
+
+inline void RKleene(MatrixView M, int threads, int baseSize) {
+    int n = M.rows;
+    if (n <= baseSize) {
+        FloydWarshallBlock(M);
+        return;
+    }
+    int h = std::max(MATRIX_TILE, n / 2 / MATRIX_TILE * MATRIX_TILE);
+    MatrixView A = M.Block(0, 0, h, h), B = M.Block(0, h, h, n - h);
+    MatrixView C = M.Block(h, 0, n - h, h), D = M.Block(h, h, n - h, n - h);
+
+    RKleene(A, threads, baseSize);
+    RunPair(threads, [&](int t) { MinPlusMultiplyAdd(B, A, B, t); },
+                     [&](int t) { MinPlusMultiplyAdd(C, C, A, t); });
+    MinPlusMultiplyAdd(D, C, B, threads);
+    RKleene(D, threads, baseSize);
+    RunPair(threads, [&](int t) { MinPlusMultiplyAdd(B, B, D, t); },
+                     [&](int t) { MinPlusMultiplyAdd(C, D, C, t); });
+    MinPlusMultiplyAdd(A, B, C, threads);
+}
+
+} // namespace min_plus_internal
+
+/* R-Kleene APSP: split the matrix into quadrants [A B; C D] and compute its closure as
+ *   A = A*, B = A B, C = C A, D = (D + C B)*, B = B D, C = D C, A = A + B C
+ * recursively. Every level works on ever smaller blocks, so the algorithm adapts to all cache levels without
+ * tuning (cache-oblivious), and the two independent products of each step run as separate tasks.
+ */
+inline void RKleeneAPSP(DistanceMatrix &D, int threads = 0, int baseSize = 128) {
+    if (threads <= 0) threads = min_plus_internal::DefaultThreads();
+    min_plus_internal::RKleene(D.View(), threads, std::max(baseSize, MATRIX_TILE));
+    NormalizeInfinity(D);
+}
@@ -0,0 +1,119 @@
+/* [Description]
+ * This header contains a MultiQueue, the relaxed concurrent priority queue used by the parallel Dijkstra of
+ * ParallelDijkstraMultiQueue.cpp. A single shared heap serializes all threads on its lock; a MultiQueue spreads
+ * the entries over c * p sequential heaps (p threads), each behind its own try-lock, and gives up exact order:
+ * - Push() puts the entry into a random heap whose lock it can take at once.
+ * - TryPop() looks at the cached minimum of two random heaps and pops from the better one, so it returns an
+ *   entry close to, but not necessarily at, the global minimum. With c >= 2 the expected rank error stays
+ *   O(c * p) and the chance that two threads want the same lock is small.
+ * The heaps are BinaryHeapQueue (search_workspace.h) or anything with its interface plus Top(). The monotone
+ * queues of dijkstra_queues.h do not fit: a thread may push a key below what another thread already popped
+ * from the same heap, which a radix heap or Dial's buckets cannot accept.
+ * Each heap is padded to its own cache lines so that the locks and cached minima of neighbors do not share a
+ * line. The cached minimum is written under the lock and read without it; a stale value only makes the choice
+ * between the two heaps worse, never wrong.
+ *
+ * Libraries:
+ * - atomic, memory, limits, utility, cstdint: Try-locks, cached minima, the heap array and the random choices.
+ * - search_workspace.h: BinaryHeapQueue, the default sequential heap.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include "search_workspace.h"
+
+// xorshift64*, one per thread: the random heap choices must not contend on a shared generator.
+class MultiQueueRng {
+public:
+    explicit MultiQueueRng(std::uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull | 1) {}
+
+    std::uint64_t Next() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 0x2545F4914F6CDD1Dull;
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+template<typename Queue = BinaryHeapQueue>
+class MultiQueue {
+public:
+    static constexpr long long EMPTY = std::numeric_limits<long long>::max();
+
+    explicit MultiQueue(int queueCount) : count_(queueCount < 1 ? 1 : queueCount), slots_(new Slot[count_]) {}
+
+    MultiQueue(const MultiQueue &) = delete;
+    MultiQueue &operator=(const MultiQueue &) = delete;
+
+    int QueueCount() const { return count_; }
+
+    void Push(long long d, int v, MultiQueueRng &rng) {
+        Slot *slot;
+        do slot = &slots_[rng.Next() % count_];
+        while (!slot->TryLock());
+        slot->queue.Push(d, v);
+        slot->top.store(slot->queue.Top().first, std::memory_order_relaxed);
+        slot->Unlock();
+    }
+
+    /* Pops an entry from the better of two random heaps into out. Returns false only after a full scan found
+     * every heap empty or locked; the caller decides whether that means the work is done.
+     */
+    bool TryPop(std::pair<long long, int> &out, MultiQueueRng &rng) {
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            Slot *a = &slots_[rng.Next() % count_], *b = &slots_[rng.Next() % count_];
+            if (b->top.load(std::memory_order_relaxed) < a->top.load(std::memory_order_relaxed)) a = b;
+            if (a->top.load(std::memory_order_relaxed) != EMPTY && PopFrom(*a, out)) return true;
+        }
+        // The random choices keep missing: few entries are left, so look at every heap once.
+        int start = (int)(rng.Next() % count_);
+        for (int i = 0; i < count_; ++i) {
+            Slot &slot = slots_[(start + i) % count_];
+            if (slot.top.load(std::memory_order_relaxed) != EMPTY && PopFrom(slot, out)) return true;
+        }
+        return false;
+    }
+
+    // Bytes held by the heaps. Not synchronized: call it when no thread is using the queue.
+    size_t Bytes() const {
+        size_t bytes = sizeof(Slot) * count_;
+        for (int i = 0; i < count_; ++i) bytes += slots_[i].queue.Bytes();
+        return bytes;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<bool> locked{false};
+        std::atomic<long long> top{EMPTY};
+        Queue queue;
+
+        bool TryLock() {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+        void Unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    static bool PopFrom(Slot &slot, std::pair<long long, int> &out) {
+        if (!slot.TryLock()) return false;
+        bool popped = !slot.queue.Empty();
+        if (popped) {
+            out = slot.queue.Pop();
+            slot.top.store(slot.queue.Empty() ? EMPTY : slot.queue.Top().first, std::memory_order_relaxed);
+        }
+        slot.Unlock();
+        return popped;
+    }
+
+    int count_;
+    std::unique_ptr<Slot[]> slots_;
+};
@@ -0,0 +1,227 @@
+/* [Description]
+ * This header contains the allocation layer for large graph and distance arrays: huge pages against TLB misses
+ * and NUMA placement against remote-memory traffic on multi-socket machines. It talks to the kernel directly
+ * (mmap, madvise, and the mbind/set_mempolicy system calls), so it needs no libnuma.
+ * - MemoryOptions: which techniques are on. Read once from the GRAPH_MEMORY environment variable
+ *   ("huge", "interleave", "huge,interleave"; unset or "default" = neither), so any program can be A/B
+ *   benchmarked without recompiling: GRAPH_MEMORY=huge,interleave ./MinPlusAPSP
+ *   - huge: mappings of 2 MiB or more are 2 MiB-aligned and try MAP_HUGETLB (the reserved pool) first, then
+ *     fall back to transparent huge pages via madvise(MADV_HUGEPAGE).
+ *   - interleave: mappings are spread page by page over all NUMA nodes (mbind MPOL_INTERLEAVE), and the
+ *     process policy is set to interleave too, so ordinary heap allocations follow. Without it, memory is
+ *     placed by first touch, which is why the parallel engines initialize their arrays in parallel.
+ * - LargePageAllocator<T>: an std::allocator replacement that takes every allocation from such a mapping.
+ * - LargeArray<T>: a fixed-size array on such a mapping. The kernel zero-fills it and nothing touches it
+ *   before the owner does, so ParallelFill/the copy constructor decide on which node each part lands.
+ *
+ * Libraries:
+ * - cstddef, cstdint, cstdlib, cstring, string, vector, thread, algorithm, new: Sizes, parsing, parallel fill.
+ * - sys/mman.h, sys/syscall.h, unistd.h: mmap/madvise and the raw NUMA system calls (Linux).
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct MemoryOptions {
+    bool hugePages = false;
+    bool interleave = false;
+};
+
+namespace numa_internal {
+
+const size_t HUGE_PAGE = size_t(2) << 20;
+const int MPOL_INTERLEAVE_MODE = 3;   // from linux/mempolicy.h
+
+// Bit mask of the online NUMA nodes, from /sys ("0", "0-1", "0,2-3"); node 0 alone if it cannot be read.
+inline unsigned long OnlineNodes() {
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string spec;
+    unsigned long mask = 0;
+    if (file >> spec) {
+        size_t pos = 0;
+        while (pos < spec.size()) {
+            size_t end = spec.find(',', pos);
+            if (end == std::string::npos) end = spec.size();
+            std::string part = spec.substr(pos, end - pos);
+            size_t dash = part.find('-');
+            int lo = std::atoi(part.c_str()), hi = dash == std::string::npos ? lo : std::atoi(part.c_str() + dash + 1);
+            for (int node = lo; node <= hi && node < 64; ++node) mask |= 1UL << node;
+            pos = end + 1;
+        }
+    }
+    return mask ? mask : 1UL;
+}
+
+inline size_t MappedSize(size_t bytes) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t unit = bytes >= HUGE_PAGE ? HUGE_PAGE : page;
+    return (bytes + unit - 1) / unit * unit;
+}
+
+} // namespace numa_internal
+
+inline int NumaNodeCount() { return __builtin_popcountl(numa_internal::OnlineNodes()); }
+
+inline MemoryOptions ParseMemoryOptions(const char *spec) {
+    MemoryOptions options;
+    std::string s = spec ? spec : "";
+    options.hugePages = s.find("huge") != std::string::npos;
+    options.interleave = s.find("interleave") != std::string::npos;
+    return options;
+}
+
+inline std::string DescribeMemoryOptions(const MemoryOptions &options) {
+    std::string s = options.hugePages ? "huge pages" : "normal pages";
+    s += options.interleave ? ", interleaved over " : ", first touch on ";
+    s += std::to_string(NumaNodeCount()) + " NUMA node(s)";
+    return s;
+}
+
+/* The options of this process, from GRAPH_MEMORY. The first call also applies the process-wide part (the
+ * interleave policy), so programs call it at the start of main, before any worker thread exists.
+ */
+inline const MemoryOptions &GlobalMemoryOptions() {
+    static const MemoryOptions options = [] {
+        MemoryOptions o = ParseMemoryOptions(std::getenv("GRAPH_MEMORY"));
+        if (o.interleave) {
+            unsigned long nodes = numa_internal::OnlineNodes();
+            syscall(SYS_set_mempolicy, numa_internal::MPOL_INTERLEAVE_MODE, &nodes, sizeof(nodes) * 8);
+        }
+        return o;
+    }();
+    return options;
+}
+
+// Maps bytes of zeroed memory according to the global options. Returns nullptr on failure.
+inline void *MapLarge(size_t bytes) {
+    using namespace numa_internal;
+    const MemoryOptions &options = GlobalMemoryOptions();
+    size_t size = MappedSize(bytes);
+    void *p = MAP_FAILED;
+    if (options.hugePages && size >= HUGE_PAGE)
+        p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED && options.hugePages && size >= HUGE_PAGE) {
+        // Over-map by one huge page and trim, so the region is 2 MiB-aligned and THP can back all of it.
+        char *raw = (char *)mmap(nullptr, size + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw != MAP_FAILED) {
+            char *aligned = (char *)(((uintptr_t)raw + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1));
+            if (aligned > raw) munmap(raw, aligned - raw);
+            munmap(aligned + size, raw + HUGE_PAGE - aligned);
+            madvise(aligned, size, MADV_HUGEPAGE);
+            p = aligned;
+        }
+    }
+    if (p == MAP_FAILED) p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    if (options.interleave) {
+        unsigned long nodes = OnlineNodes();
+        syscall(SYS_mbind, p, size, MPOL_INTERLEAVE_MODE, &nodes, sizeof(nodes) * 8, 0);
+    }
+    return p;
+}
+
+inline void UnmapLarge(void *p, size_t bytes) {
+    if (p) munmap(p, numa_internal::MappedSize(bytes));
+}
+
+// Runs body(from, to) over [0, count) split into contiguous ranges, one per thread (threads <= 0: all cores).
+template<typename F>
+void ParallelRanges(size_t count, int threads, F body) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 1 || count < 4096) {
+        body(size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back(body, count * t / threads, count * (t + 1) / threads);
+    for (auto &th : pool) th.join();
+}
+
+template<typename T>
+struct LargePageAllocator {
+    using value_type = T;
+
+    LargePageAllocator() = default;
+    template<typename U>
+    LargePageAllocator(const LargePageAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        if (n == 0) return nullptr;
+        void *p = MapLarge(n * sizeof(T));
+        if (!p) throw std::bad_alloc();
+        return (T *)p;
+    }
+    void deallocate(T *p, size_t n) { UnmapLarge(p, n * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const LargePageAllocator<U> &) const { return true; }
+    template<typename U>
+    bool operator!=(const LargePageAllocator<U> &) const { return false; }
+};
+
+template<typename T>
+using LargeVector = std::vector<T, LargePageAllocator<T>>;
+
+// Fixed-size array of trivially copyable T on a large mapping; starts out zeroed and untouched.
+template<typename T>
+class LargeArray {
+public:
+    explicit LargeArray(size_t size = 0) : size_(size) {
+        if (size_ && !(data_ = (T *)MapLarge(size_ * sizeof(T)))) throw std::bad_alloc();
+    }
+    // Copies in parallel, so the copy is placed like the original was initialized.
+    LargeArray(const LargeArray &o) : LargeArray(o.size_) {
+        ParallelRanges(size_, 0, [&](size_t from, size_t to) {
+            if (to > from) std::memcpy(data_ + from, o.data_ + from, (to - from) * sizeof(T));
+        });
+    }
+    LargeArray(LargeArray &&o) noexcept : data_(o.data_), size_(o.size_) {
+        o.data_ = nullptr;
+        o.size_ = 0;
+    }
+    LargeArray &operator=(LargeArray o) noexcept {
+        std::swap(data_, o.data_);
+        std::swap(size_, o.size_);
+        return *this;
+    }
+    ~LargeArray() { UnmapLarge(data_, size_ * sizeof(T)); }
+
+    size_t size() const { return size_; }
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+    T &operator[](size_t i) { return data_[i]; }
+    const T &operator[](size_t i) const { return data_[i]; }
+    T *begin() { return data_; }
+    T *end() { return data_ + size_; }
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size_; }
+
+    bool operator==(const LargeArray &o) const {
+        return size_ == o.size_ && (size_ == 0 || std::memcmp(data_, o.data_, size_ * sizeof(T)) == 0);
+    }
+
+    // Writes value everywhere with the given number of threads; the first touch places each range's pages.
+    void ParallelFill(const T &value, int threads = 0) {
+        ParallelRanges(size_, threads, [&](size_t from, size_t to) { std::fill(data_ + from, data_ + to, value); });
+    }
+
+private:
+    T *data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+# [Description]
+# Prefetch sweep: measures the software prefetching of relax_prefetch.h on a graph larger than the last-level
+# cache. Every engine that supports it is built once per prefetch distance (-DPREFETCH_DISTANCE=k, 0 = off),
+# run REPEATS times on the same graph with its bench_report.h records collected per distance, and each
+# distance is compared with k = 0 by BenchCompare (Welch's t-test on the total and per-phase times), so
+# faster phases are listed as improvements and slower ones as regressions.
+# The default graph (N = 3 * 10^5, D = 6 * 10^-5, about 2.7 * 10^6 edges) takes roughly 45 MB as an adjacency
+# list, beyond the LLC of most machines; on graphs that fit in the cache the prefetches can only cost time.
+# The generator only writes connected graphs, so like scaling_sweep.sh the script refuses a density below about
+# ln(N) / N, where almost no attempt would succeed, instead of letting the generator retry for minutes.
+#
+# Usage: ./prefetch_sweep.sh           (all settings below can be overridden from the environment)
+#   N=300000   D=0.00006   NEGATIVE=false   DISTANCES="0 4 8 16 32"   REPEATS=5   OUT=prefetch   SEED=2025
+#   ENGINES="DijkstraAdjacencyList DijkstraDHeapAdjacencyList SPFA SPFADeque"
+#
+# Author: H. Hristov
+# Ruse, 2025
+set -u
+
+N=${N:-300000}
+D=${D:-0.00006}
+NEGATIVE=${NEGATIVE:-false}
+DISTANCES=${DISTANCES:-"0 4 8 16 32"}
+REPEATS=${REPEATS:-5}
+OUT=${OUT:-prefetch}
+SEED=${SEED:-2025}
+ENGINES=${ENGINES:-"DijkstraAdjacencyList DijkstraDHeapAdjacencyList SPFA SPFADeque"}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++20 -O2 -march=native -pthread"}
+
+connected=$(awk -v n="$N" -v d="$D" 'BEGIN { print (d * n >= 1.2 * log(n)) ? 1 : 0 }')
+if [ "$connected" -eq 0 ]; then
+    minD=$(awk -v n="$N" 'BEGIN { printf "%g", 1.2 * log(n) / n }')
+    echo "D = $D is too sparse for N = $N to be connected; use D >= $minD"
+    exit 1
+fi
+
+cd "$(dirname "$0")"
+mkdir -p "$OUT/bin" "$OUT/graphs" "$OUT/logs"
+OUT=$(cd "$OUT" && pwd)
+
+echo "Building..."
+for tool in testGenerator BenchCompare; do
+    $CXX $CXXFLAGS $tool.cpp -o "$OUT/bin/$tool" || exit 1
+done
+for k in $DISTANCES; do
+    for engine in $ENGINES; do
+        $CXX $CXXFLAGS -DPREFETCH_DISTANCE="$k" $engine.cpp -o "$OUT/bin/${engine}_k$k" || exit 1
+    done
+done
+
+file="$OUT/graphs/graph_N${N}_D$(printf '%f' "$D")_neg${NEGATIVE}_1.in"
+if [ ! -f "$file" ]; then
+    echo "Generating graph..."
+    (cd "$OUT/graphs" && "$OUT/bin/testGenerator" "$N" "$D" "$NEGATIVE" 1 "$SEED" > /dev/null) || exit 1
+fi
+
+# Distances are interleaved within each repetition, so that drifts of the machine affect all of them alike.
+for ((r = 1; r <= REPEATS; ++r)); do
+    for engine in $ENGINES; do
+        for k in $DISTANCES; do
+            log="$OUT/logs/${engine}_k${k}_${r}.log"
+            BENCH_OUTPUT="$OUT/k$k.jsonl" "$OUT/bin/${engine}_k$k" "$file" > "$log" 2>&1 ||
+                echo "$engine (k = $k): exit status $? (see $log)"
+        done
+    done
+    echo "Repetition $r done"
+done
+
+for k in $DISTANCES; do
+    if [ "$k" -eq 0 ]; then continue; fi
+    echo
+    echo "=== Prefetch distance $k vs none ==="
+    "$OUT/bin/BenchCompare" "$OUT/k0.jsonl" "$OUT/k$k.jsonl" | tee "$OUT/compare_k$k.txt"
+done
@@ -0,0 +1,58 @@
+/* [Description]
+ * This header contains an arena for the scratch structures of query engines (workspace arrays, queues, row
+ * buffers). It is a std::pmr resource, so anything built on std::pmr containers takes it as a constructor
+ * parameter, e.g. SearchWorkspace ws(n, arena.Resource()) or DialQueue dial(C, arena.Resource()).
+ * - The bottom layer is a monotonic buffer: one block reserved up front, carved by bumping a pointer and
+ *   extended from the upstream resource only if the estimate was too small.
+ * - On top of it sits an unsynchronized pool, so memory freed while vectors grow to their working size is
+ *   reused instead of lost. Nothing is returned to the system before the arena is destroyed or Release()d.
+ * The engines keep their containers between queries, so once they have reached their working size a batch of
+ * queries or an APSP run performs no heap allocations at all. One arena per thread: it is not synchronized.
+ *
+ * Libraries:
+ * - memory_resource: monotonic_buffer_resource and unsynchronized_pool_resource.
+ * - memory, cstddef: The initial block.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+class QueryArena {
+public:
+    explicit QueryArena(size_t initialBytes = size_t(1) << 16,
+                        std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : size_(initialBytes), block_(new std::byte[initialBytes]),
+          monotonic_(block_.get(), initialBytes, upstream), pool_(&monotonic_) {}
+
+    QueryArena(const QueryArena &) = delete;
+    QueryArena &operator=(const QueryArena &) = delete;
+
+    std::pmr::memory_resource *Resource() { return &pool_; }
+
+    // Frees everything allocated from the arena at once. All containers using it must be gone by then.
+    void Release() {
+        pool_.release();
+        monotonic_.release();
+    }
+
+    size_t InitialBytes() const { return size_; }
+
+    // A starting size for an arena holding a SearchWorkspace of vertexCount vertices and a queue of about
+    // queueEntries (distance, vertex) pairs. Pass a V-sized guess, not the edge count: a lazy heap rarely holds
+    // more than a few entries per vertex, and the arena extends itself from upstream if a search needs more.
+    static size_t WorkspaceBytes(int vertexCount, size_t queueEntries) {
+        // dist + parent + two stamps per vertex, 16 bytes per queue entry, doubled for vector growth.
+        return 2 * ((size_t)vertexCount * (8 + 4 + 4 + 4) + queueEntries * 16) + 4096;
+    }
+
+private:
+    size_t size_;
+    std::unique_ptr<std::byte[]> block_;
+    std::pmr::monotonic_buffer_resource monotonic_;
+    std::pmr::unsynchronized_pool_resource pool_;
+};
@@ -0,0 +1,155 @@
+/* [Description]
+ * This header contains the binary protocol spoken by ShortestPathServer and ShortestPathClient over a Unix
+ * domain socket, and the latency histogram both of them report.
+ * Every request is a 16-byte RequestHeader followed by its payload; every answer is a 16-byte ResponseHeader
+ * followed by header.bytes of payload. All fields are little-endian, vertices are int32, distances int64 with
+ * INT64_MAX for unreachable targets:
+ * - Info:     count = 0                              -> int64 vertexCount, int64 edgeCount, int64 negative (0/1)
+ * - SSSP:     count sources, int32 source[count]     -> int64 dist[count][vertexCount]
+ * - Pairs:    count pairs, int32 (s, t)[count]       -> int64 dist[count]
+ * - Table:    count sources, extra targets, int32 source[count], int32 target[extra]
+ *                                                    -> int64 dist[count][extra], row-major
+ * - Stats:    count = 0                              -> the server's latency report as text
+ * - Shutdown: count = 0                              -> empty; the server stops accepting and exits
+ * A malformed request (unknown type, vertex out of range, too large) gets status BadRequest and no payload,
+ * and the server closes the connection, since the rest of the stream can no longer be parsed.
+ * LatencyHistogram keeps power-of-two buckets (with four linear sub-buckets each) of nanoseconds, so recording
+ * is a couple of instructions and the percentiles are exact to within 25%.
+ *
+ * Libraries:
+ * - cstdint, cstring, string, vector, array, algorithm, sstream: Fixed-width headers, the histogram and its report.
+ * - sys/socket.h, sys/un.h, unistd.h, cerrno: Socket addresses and full reads/writes.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+enum class QueryType : uint32_t { Info = 0, SSSP = 1, Pairs = 2, Table = 3, Stats = 4, Shutdown = 5 };
+enum class QueryStatus : uint32_t { Ok = 0, BadRequest = 1 };
+
+constexpr char QUERY_MAGIC[4] = {'S', 'P', 'Q', '1'};
+constexpr int64_t QUERY_UNREACHABLE = INT64_MAX;
+// Upper bound on one response, so a single request cannot make the server allocate without limit.
+constexpr uint64_t QUERY_MAX_RESPONSE_BYTES = uint64_t(1) << 30;
+
+struct RequestHeader {
+    char magic[4];
+    QueryType type;
+    uint32_t count;
+    uint32_t extra;
+};
+
+struct ResponseHeader {
+    QueryStatus status;
+    uint32_t reserved;
+    uint64_t bytes;
+};
+
+static_assert(sizeof(RequestHeader) == 16 && sizeof(ResponseHeader) == 16, "protocol headers must be 16 bytes");
+
+// Reads or writes exactly bytes bytes, retrying on short transfers and EINTR. False on EOF or error.
+inline bool ReadFull(int fd, void *data, size_t bytes) {
+    char *p = static_cast<char *>(data);
+    while (bytes > 0) {
+        ssize_t got = read(fd, p, bytes);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got;
+        bytes -= got;
+    }
+    return true;
+}
+
+inline bool WriteFull(int fd, const void *data, size_t bytes) {
+    const char *p = static_cast<const char *>(data);
+    while (bytes > 0) {
+        ssize_t put = send(fd, p, bytes, MSG_NOSIGNAL);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put;
+        bytes -= put;
+    }
+    return true;
+}
+
+// Fills a sockaddr_un for path; false if the path does not fit.
+inline bool UnixAddress(const std::string &path, sockaddr_un &address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+class LatencyHistogram {
+public:
+    void Record(uint64_t ns) {
+        ++buckets_[Bucket(ns)];
+        ++count_;
+        sum_ += ns;
+        max_ = std::max(max_, ns);
+    }
+
+    void Merge(const LatencyHistogram &o) {
+        for (size_t i = 0; i < buckets_.size(); ++i) buckets_[i] += o.buckets_[i];
+        count_ += o.count_;
+        sum_ += o.sum_;
+        max_ = std::max(max_, o.max_);
+    }
+
+    uint64_t Count() const { return count_; }
+
+    // Upper bound of the bucket holding the q-quantile, q in [0, 1].
+    uint64_t Percentile(double q) const {
+        uint64_t rank = (uint64_t)(q * count_), seen = 0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            seen += buckets_[i];
+            if (seen > rank) return std::min(UpperBound(i), max_);
+        }
+        return max_;
+    }
+
+    // "name: count, mean, p50, p90, p99, p99.9, max" in microseconds.
+    std::string Report(const std::string &name) const {
+        std::ostringstream out;
+        out.setf(std::ios::fixed);
+        out.precision(1);
+        out << name << ": " << count_ << " requests";
+        if (count_) {
+            out << ", mean " << sum_ / 1e3 / count_ << " us, p50 " << Percentile(0.5) / 1e3 << " us, p90 "
+                << Percentile(0.9) / 1e3 << " us, p99 " << Percentile(0.99) / 1e3 << " us, p99.9 "
+                << Percentile(0.999) / 1e3 << " us, max " << max_ / 1e3 << " us";
+        }
+        return out.str();
+    }
+
+private:
+    // Bucket 4k + s covers [2^k + s 2^(k-2), 2^k + (s+1) 2^(k-2)) for k >= 2; values below 4 get their own buckets.
+    static size_t Bucket(uint64_t ns) {
+        if (ns < 4) return ns;
+        int k = 63 - __builtin_clzll(ns);
+        return 4 * k + ((ns >> (k - 2)) & 3);
+    }
+    static uint64_t UpperBound(size_t bucket) {
+        if (bucket < 4) return bucket;
+        int k = (int)bucket / 4;
+        uint64_t s = bucket % 4;
+        return (uint64_t(1) << k) + ((s + 1) << (k - 2)) - 1;
+    }
+
+    std::array<uint64_t, 256> buckets_{};
+    uint64_t count_ = 0, sum_ = 0, max_ = 0;
+};
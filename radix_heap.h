@@ -3,6 +3,8 @@
  * 
  * Author: Unknown
  */
+#pragma once
+
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -10,6 +12,7 @@
 #include <cstdint>
 #include <limits>
 #include <type_traits>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -255,6 +258,13 @@ class pair_radix_heap {
     return size_ == 0;
   }
 
+  // Bytes held by the buckets (their capacities, which clear() and pop() keep).
+  size_t bytes() const {
+    size_t total = 0;
+    for (const auto &b : buckets_) total += b.capacity() * sizeof(typename decltype(buckets_)::value_type::value_type);
+    return total;
+  }
+
   void clear() {
     size_ = 0;
     last_ = key_type();
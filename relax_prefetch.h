@@ -0,0 +1,66 @@
+/* [Description]
+ * This header contains the optional software prefetching used in the relaxation loops of the single-source
+ * engines. On a graph larger than the last-level cache the distance entry of almost every neighbor is a cache
+ * miss, and so is the adjacency row of the next vertex taken from the queue; the hardware prefetcher cannot
+ * predict either, because the addresses come from the edge targets and the queue order.
+ * - RelaxPrefetcher<Distance>: Start() prefetches the distance entries of the first Distance targets of a row;
+ *   then, while the loop relaxes edge i, Ahead() prefetches the entry of the target of edge i + Distance, so
+ *   the line arrives by the time the loop reaches it. Next() prefetches the row header, the first edges and
+ *   the distance entry of the vertex the queue will most likely hand out next (the heap top, the queue front)
+ *   while the current row is still being relaxed.
+ * - Distance = 0 is the default: the class is empty and every call compiles to nothing, like ParentTracker and
+ *   EngineStats, so the loops are unchanged. A good distance is about the miss latency divided by the time of
+ *   one relaxation, typically 4 to 16; for rows shorter than that, Start() covers the whole row.
+ * Each program picks its distance with its own "constexpr int prefetchDistance"; building with
+ * -DPREFETCH_DISTANCE=k sets the default of all of them at once (prefetch_sweep.sh compares several k).
+ *
+ * Libraries:
+ * - cstddef: Edge indices.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <cstddef>
+
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 0
+#endif
+
+constexpr int PREFETCH_DISTANCE_DEFAULT = PREFETCH_DISTANCE;
+
+template<int Distance>
+class RelaxPrefetcher {
+    static_assert(Distance >= 0, "the prefetch distance cannot be negative");
+
+public:
+    // Prefetches dist[row[i].first] for the first Distance edges of the row, before the loop starts.
+    template<typename Row, typename Dist>
+    void Start(const Row &row, const Dist &dist) const {
+        if constexpr (Distance > 0) {
+            size_t stop = row.size() < (size_t)Distance ? row.size() : (size_t)Distance;
+            for (size_t i = 0; i < stop; ++i) __builtin_prefetch(&dist[row[i].first], 1);
+        }
+    }
+
+    // Prefetches dist[row[i + Distance].first] (for rows of (target, weight) pairs) if that edge exists.
+    template<typename Row, typename Dist>
+    void Ahead(const Row &row, size_t i, const Dist &dist) const {
+        if constexpr (Distance > 0) {
+            if (i + Distance < row.size()) __builtin_prefetch(&dist[row[i + Distance].first], 1);
+        }
+    }
+
+    // Prefetches the adjacency row of v and the first edges it holds, and dist[v].
+    template<typename Adjacency, typename Dist>
+    void Next(const Adjacency &adj, int v, const Dist &dist) const {
+        if constexpr (Distance > 0) {
+            __builtin_prefetch(&adj[v]);
+            __builtin_prefetch(adj[v].data());
+            __builtin_prefetch(&dist[v]);
+        }
+    }
+
+    static constexpr int distance = Distance;
+};
@@ -0,0 +1,134 @@
+#!/usr/bin/env bash
+# [Description]
+# Scaling sweep: generates Erdos-Renyi graphs over a grid of sizes and densities with testGenerator, runs every
+# engine on every graph it can handle (and for the parallel engines at every thread count), collects the
+# bench_report.h records in one file and fits the empirical complexity exponents with ScalingFit.
+# This replaces editing filePath in each program by hand: every benchmark takes the graph file as its first
+# argument and the parallel ones the thread count as their second.
+#
+# Usage: ./scaling_sweep.sh            (all settings below can be overridden from the environment)
+#   SIZES="100 1000 10000 100000 1000000"   DENSITIES="0.00002 0.0002 0.001 0.01 0.1 0.5 0.9"
+#   THREADS="1 0"   (0 = all cores)   REPEATS=3   TIMEOUT=600 (seconds per run)   MAX_EDGES=20000000
+#   ENGINES="DijkstraAdjacencyList SPFA"    (default: all)   OUT=sweep   NEGATIVE=false   SEED=2025
+# Graphs are undirected in the generator but written once, from the smaller to the larger id, so even with
+# NEGATIVE=true they have no negative cycles. The Dijkstra engines need non-negative weights and are not run
+# when NEGATIVE=true.
+# A size/density pair is skipped, with the reason printed, when the generator could not connect it (D below
+# about 1.2 ln(N) / N) or when it would have more than MAX_EDGES edges. The two sparsest default densities sit
+# just above that bound for N = 10^6 (10^7 edges) and N = 10^5 (10^6 edges), the only densities at which
+# those sizes are both connected and within MAX_EDGES. An engine that times out on a density is not run on
+# larger sizes.
+#
+# Author: H. Hristov
+# Ruse, 2025
+set -u
+
+SIZES=${SIZES:-"100 1000 10000 100000 1000000"}
+DENSITIES=${DENSITIES:-"0.00002 0.0002 0.001 0.01 0.1 0.5 0.9"}
+THREADS=${THREADS:-"1 0"}
+REPEATS=${REPEATS:-3}
+TIMEOUT=${TIMEOUT:-600}
+MAX_EDGES=${MAX_EDGES:-20000000}
+OUT=${OUT:-sweep}
+NEGATIVE=${NEGATIVE:-false}
+SEED=${SEED:-2025}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++20 -O2 -march=native -pthread"}
+
+# engine:largest N:parallel (takes a thread count):negative weights (handles them)
+ALL_ENGINES="
+DijkstraAdjacencyList:1000000:0:0
+DijkstraDHeapAdjacencyList:1000000:0:0
+ReadixHeapDijkstraAdjacencyList:1000000:0:0
+AStarAdjacencyList:1000000:0:0
+SPFA:1000000:0:1
+SPFADeque:1000000:0:1
+BellmanFordAdjacencyList:100000:0:1
+CompressedCSRBenchmark:1000000:0:1
+MultiQueryDijkstraAdjacencyList:100000:0:0
+DynamicDijkstraAdjacencyList:1000000:0:0
+MultiSourceBellmanFord:100000:0:1
+IncrementalJohnsonAdjacencyList:2000:0:1
+ParallelDijkstraMultiQueue:1000000:1:0
+JohnsonAdjacencyList:10000:1:1
+FloydWarshall:2000:0:1
+MinPlusAPSP:2000:1:1
+RKleeneAPSP:2000:1:1
+"
+
+cd "$(dirname "$0")"
+mkdir -p "$OUT/bin" "$OUT/graphs" "$OUT/logs" "$OUT/plot"
+OUT=$(cd "$OUT" && pwd)
+RESULTS="$OUT/results.jsonl"
+
+echo "Building..."
+for tool in testGenerator ScalingFit; do
+    $CXX $CXXFLAGS $tool.cpp -o "$OUT/bin/$tool" || exit 1
+done
+for spec in $ALL_ENGINES; do
+    IFS=: read -r engine maxN parallel negativeOk <<< "$spec"
+    if [ -n "${ENGINES:-}" ] && [[ " $ENGINES " != *" $engine "* ]]; then continue; fi
+    if [ "$NEGATIVE" = true ] && [ "$negativeOk" -eq 0 ]; then
+        echo "$engine: skipped, it needs non-negative weights (NEGATIVE=true)"
+        continue
+    fi
+    $CXX $CXXFLAGS $engine.cpp -o "$OUT/bin/$engine" || exit 1
+done
+
+echo "Generating graphs..."
+GRAPHS=()
+for n in $SIZES; do
+    for d in $DENSITIES; do
+        edges=$(awk -v n="$n" -v d="$d" 'BEGIN { printf "%.0f", n * (n - 1) / 2 * d }')
+        connected=$(awk -v n="$n" -v d="$d" 'BEGIN { print (d * n >= 1.2 * log(n)) ? 1 : 0 }')
+        if [ "$connected" -eq 0 ]; then
+            echo "Skipping N=$n D=$d: too sparse to be connected (D*N < 1.2 ln N)"
+            continue
+        elif [ "$edges" -gt "$MAX_EDGES" ]; then
+            echo "Skipping N=$n D=$d: $edges edges, more than MAX_EDGES=$MAX_EDGES"
+            continue
+        fi
+        file="graph_N${n}_D$(printf '%f' "$d")_neg${NEGATIVE}_1.in"
+        if [ ! -f "$OUT/graphs/$file" ]; then
+            (cd "$OUT/graphs" && "$OUT/bin/testGenerator" "$n" "$d" "$NEGATIVE" 1 "$SEED" > /dev/null) || continue
+        fi
+        GRAPHS+=("$n:$d:$OUT/graphs/$file")
+    done
+done
+echo "${#GRAPHS[@]} graphs."
+
+# Runs are kept in order of increasing N so that a timeout can rule out the larger sizes.
+declare -A TOO_SLOW
+for spec in $ALL_ENGINES; do
+    IFS=: read -r engine maxN parallel negativeOk <<< "$spec"
+    if [ ! -x "$OUT/bin/$engine" ] || { [ "$NEGATIVE" = true ] && [ "$negativeOk" -eq 0 ]; }; then continue; fi
+    threadList=1
+    if [ "$parallel" -eq 1 ]; then threadList=$THREADS; fi
+    for graph in "${GRAPHS[@]}"; do
+        IFS=: read -r n d file <<< "$graph"
+        if [ "$n" -gt "$maxN" ] || [ -n "${TOO_SLOW[$engine:$d]:-}" ]; then continue; fi
+        for t in $threadList; do
+            for ((r = 1; r <= REPEATS; ++r)); do
+                log="$OUT/logs/${engine}_$(basename "$file" .in)_t${t}_${r}.log"
+                BENCH_OUTPUT="$RESULTS" timeout "$TIMEOUT" "$OUT/bin/$engine" "$file" "$t" > "$log" 2>&1
+                status=$?
+                if [ $status -eq 124 ]; then
+                    echo "$engine: timed out on N=$n D=$d, skipping larger graphs of this density"
+                    TOO_SLOW[$engine:$d]=1
+                    break 2
+                elif [ $status -ne 0 ]; then
+                    echo "$engine: exit status $status on N=$n D=$d (see $log)"
+                fi
+            done
+        done
+        if [ -z "${TOO_SLOW[$engine:$d]:-}" ]; then echo "$engine: N=$n D=$d done"; fi
+    done
+done
+
+echo
+"$OUT/bin/ScalingFit" "$RESULTS" "$OUT/plot" | tee "$OUT/fits.txt"
+if command -v gnuplot > /dev/null; then
+    gnuplot "$OUT/plot/scaling.gp" && echo "Plot: $OUT/plot/scaling.png"
+else
+    echo "gnuplot not found, the plot data is in $OUT/plot"
+fi
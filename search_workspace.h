@@ -0,0 +1,244 @@
+/* [Description]
+ * This header contains a reusable workspace for running many shortest path queries on the same graph,
+ * together with a small multi-query API built on top of Dijkstra's algorithm.
+ * The query functions are templates over the graph type and read it only through ForEachNeighbor(g, u, f) and
+ * VertexCount(g), so they run unchanged on an AdjacencyList, a CSRGraph or a DynamicGraph.
+ * A workspace holds the distance, parent and visited arrays for all N vertices and a binary heap whose
+ * storage is kept between queries; QueueDijkstra() accepts any other queue with the same interface.
+ * Instead of re-filling the arrays with INF before every query, each entry carries the generation in which it
+ * was last written; Reset() only bumps the generation counter, so starting a new query costs O(1) regardless
+ * of N and only the vertices touched by a query are paid for.
+ * All storage is std::pmr and comes from the memory resource given to the constructor (the default heap unless
+ * one is passed), so a QueryArena (query_arena.h) can supply it; once the arrays and the heap have grown to
+ * their working size, queries make no allocations at all.
+ *
+ * Libraries:
+ * - vector, memory_resource: Storage for the per-vertex arrays and the heap, from a caller-chosen resource.
+ * - algorithm, functional: push_heap/pop_heap with greater<> for the retained min-heap.
+ * - cstdint, limits, utility: Generation stamps, INF definition and pairs.
+ * - engine_stats.h: Optional work counters for QueueDijkstra().
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+#include "engine_stats.h"
+
+/* Binary min-heap of (distance, vertex) on a retained vector. Its capacity survives Clear(), so after the first
+ * few queries no further allocations are made. Every Dijkstra queue offers the same four operations
+ * (see dijkstra_queues.h for the radix heap and Dial's buckets).
+ */
+class BinaryHeapQueue {
+public:
+    explicit BinaryHeapQueue(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : heap_(resource) {}
+
+    void Clear() { heap_.clear(); }
+    bool Empty() const { return heap_.empty(); }
+    size_t Bytes() const { return heap_.capacity() * sizeof(std::pair<long long, int>); }
+
+    void Push(long long d, int v) {
+        heap_.emplace_back(d, v);
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<std::pair<long long, int>>());
+    }
+
+    // The entry Pop() would return; the heap must not be empty.
+    const std::pair<long long, int> &Top() const { return heap_.front(); }
+
+    std::pair<long long, int> Pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<std::pair<long long, int>>());
+        std::pair<long long, int> top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+private:
+    std::pmr::vector<std::pair<long long, int>> heap_;
+};
+
+class SearchWorkspace {
+public:
+    static constexpr long long INF = std::numeric_limits<long long>::max() / 4;
+
+    explicit SearchWorkspace(int vertexCount = 0,
+                             std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : dist_(resource), parent_(resource), distStamp_(resource), visitedStamp_(resource), heap_(resource) {
+        Resize(vertexCount);
+    }
+
+    // Grows the workspace so it can hold vertices 0..vertexCount-1. Invalidates the current query.
+    void Resize(int vertexCount) {
+        dist_.resize(vertexCount);
+        parent_.resize(vertexCount);
+        distStamp_.assign(vertexCount, 0);
+        visitedStamp_.assign(vertexCount, 0);
+        generation_ = 1;
+        heap_.Clear();
+    }
+
+    int VertexCount() const { return (int)dist_.size(); }
+
+    // Starts a new query. O(1) except once every 2^32 queries, when the stamps wrap around.
+    void Reset() {
+        heap_.Clear();
+        if (++generation_ == 0) {
+            std::fill(distStamp_.begin(), distStamp_.end(), 0);
+            std::fill(visitedStamp_.begin(), visitedStamp_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    long long Dist(int v) const { return distStamp_[v] == generation_ ? dist_[v] : INF; }
+    int Parent(int v) const { return distStamp_[v] == generation_ ? parent_[v] : -1; }
+
+    void SetDist(int v, long long d, int parent) {
+        dist_[v] = d;
+        parent_[v] = parent;
+        distStamp_[v] = generation_;
+    }
+
+    bool Visited(int v) const { return visitedStamp_[v] == generation_; }
+    void MarkVisited(int v) { visitedStamp_[v] = generation_; }
+
+    // Software prefetches of what a relaxation of v (Dist/SetDist) and a pop of v (Visited) will touch.
+    void PrefetchDist(int v) const {
+        __builtin_prefetch(&dist_[v], 1);
+        __builtin_prefetch(&distStamp_[v], 1);
+    }
+    void PrefetchVisited(int v) const { __builtin_prefetch(&visitedStamp_[v], 1); }
+
+    // The workspace's own queue, used by Dijkstra() unless another queue is passed to QueueDijkstra().
+    BinaryHeapQueue &Heap() { return heap_; }
+    // Bytes held by the per-vertex arrays and the heap.
+    size_t Bytes() const {
+        return dist_.capacity() * sizeof(long long) + parent_.capacity() * sizeof(int) +
+               (distStamp_.capacity() + visitedStamp_.capacity()) * sizeof(std::uint32_t) + heap_.Bytes();
+    }
+
+    bool HeapEmpty() const { return heap_.Empty(); }
+    void Push(long long d, int v) { heap_.Push(d, v); }
+    std::pair<long long, int> Pop() { return heap_.Pop(); }
+
+private:
+    std::uint32_t generation_ = 1;
+    std::pmr::vector<long long> dist_;
+    std::pmr::vector<int> parent_;
+    std::pmr::vector<std::uint32_t> distStamp_, visitedStamp_;
+    BinaryHeapQueue heap_;
+};
+
+using AdjacencyList = std::vector<std::vector<std::pair<int, long long>>>;
+
+template<typename F>
+inline void ForEachNeighbor(const AdjacencyList &adj, int u, F &&f) {
+    for (auto [v, w] : adj[u]) f(v, w);
+}
+
+inline int VertexCount(const AdjacencyList &adj) { return (int)adj.size(); }
+
+/* Runs Dijkstra's algorithm from source over a graph with non-negative weights, taking vertices from the given
+ * queue. The results stay readable through ws.Dist()/ws.Parent() until the next query. If target is given, the
+ * search stops as soon as the target is settled, which is all a point-to-point query needs. Relaxations and
+ * queue operations are counted in stats.
+ */
+template<typename Queue, typename Graph, bool CollectStats>
+void QueueDijkstra(const Graph &g, int source, SearchWorkspace &ws, Queue &queue, int target,
+                   EngineStats<CollectStats> &stats) {
+    ws.Reset();
+    queue.Clear();
+    ws.SetDist(source, 0, -1);
+    queue.Push(0, source);
+    stats.Push();
+    while (!queue.Empty()) {
+        auto [du, x] = queue.Pop();
+        stats.Pop();
+        if (ws.Visited(x)) {
+            stats.StalePop();
+            continue;
+        }
+        ws.MarkVisited(x);
+        if (x == target) return;
+        ForEachNeighbor(g, x, [&](int y, long long w) {
+            stats.Relax();
+            long long nd = du + w;
+            if (nd < ws.Dist(y)) {
+                ws.SetDist(y, nd, x);
+                stats.Improve();
+                queue.Push(nd, y);
+                stats.Push();
+            }
+        });
+    }
+}
+
+// The same without counters (engine_stats.h); every stats call compiles to nothing.
+template<typename Queue, typename Graph>
+void QueueDijkstra(const Graph &g, int source, SearchWorkspace &ws, Queue &queue, int target = -1) {
+    EngineStats<false> none;
+    QueueDijkstra(g, source, ws, queue, target, none);
+}
+
+// Dijkstra with the workspace's binary heap.
+template<typename Graph>
+void Dijkstra(const Graph &g, int source, SearchWorkspace &ws, int target = -1) {
+    QueueDijkstra(g, source, ws, ws.Heap(), target);
+}
+
+/* Answers a batch of point-to-point queries into answers, returning INF for unreachable targets. The output
+ * vector is cleared but keeps its capacity, so a caller that reuses it allocates nothing after the first batch.
+ */
+template<typename Graph, typename Answers>
+void DistanceQueries(const Graph &g, const std::vector<std::pair<int, int>> &queries, SearchWorkspace &ws,
+                     Answers &answers) {
+    answers.clear();
+    answers.reserve(queries.size());
+    for (auto [s, t] : queries) {
+        Dijkstra(g, s, ws, t);
+        answers.push_back(ws.Dist(t));
+    }
+}
+
+template<typename Graph>
+std::vector<long long> DistanceQueries(const Graph &g, const std::vector<std::pair<int, int>> &queries,
+                                       SearchWorkspace &ws) {
+    std::vector<long long> answers;
+    DistanceQueries(g, queries, ws, answers);
+    return answers;
+}
+
+// Computes the |sources| x |targets| distance table in row-major order, one full search per source.
+template<typename Graph, typename Table>
+void DistanceTable(const Graph &g, const std::vector<int> &sources, const std::vector<int> &targets,
+                   SearchWorkspace &ws, Table &table) {
+    table.clear();
+    table.reserve(sources.size() * targets.size());
+    for (int s : sources) {
+        Dijkstra(g, s, ws);
+        for (int t : targets) table.push_back(ws.Dist(t));
+    }
+}
+
+template<typename Graph>
+std::vector<long long> DistanceTable(const Graph &g, const std::vector<int> &sources,
+                                     const std::vector<int> &targets, SearchWorkspace &ws) {
+    std::vector<long long> table;
+    DistanceTable(g, sources, targets, ws, table);
+    return table;
+}
+
+// Vertices of the path to target found by the last query, source first; empty if target was not reached.
+inline std::vector<int> ExtractPath(const SearchWorkspace &ws, int target) {
+    std::vector<int> path;
+    if (ws.Dist(target) == SearchWorkspace::INF) return path;
+    for (int v = target; v != -1; v = ws.Parent(v)) path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
@@ -0,0 +1,100 @@
+/* [Description]
+ * This header contains the shortest-path tree support shared by the single-source engines.
+ * - ParentTracker<Enabled>: opt-in parent recording. Engines call Record(v, u) whenever they relax v from u
+ *   and Dump() at the end; with Enabled = false the class is empty and every call compiles to nothing, so the
+ *   default build pays neither memory nor time for it.
+ * - ExtractPath: walks the parents from the target back to the source in O(path length).
+ * - WriteSPT/ReadSPT: a compact binary dump of the tree that other programs can load with two reads.
+ *   Layout (little-endian): char[4] "SPT1", int32 vertexCount, int32 source, int32 reserved,
+ *   then int64 dist[vertexCount] (INT64_MAX = unreachable), then int32 parent[vertexCount] (-1 = none).
+ *
+ * Libraries:
+ * - vector, string, algorithm: Parent array, file names and path reversal.
+ * - cstdio, cstdint, cstring, limits: Binary file I/O and the fixed-width layout.
+ *
+ * Author: H. Hristov
+ * Ruse, 2025
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Vertices of the tree path from the root to target, root first; empty if target is not in the tree.
+inline std::vector<int> ExtractPath(const std::vector<int> &parent, int source, int target) {
+    std::vector<int> path;
+    if (target != source && parent[target] == -1) return path;
+    for (int v = target; v != -1 && path.size() <= parent.size(); v = (v == source ? -1 : parent[v]))
+        path.push_back(v);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/* Writes the tree in the SPT1 format. Distances >= unreachable are stored as INT64_MAX, so the file does not
+ * depend on which INF an engine happens to use. Returns false if the file cannot be written.
+ */
+inline bool WriteSPT(const std::string &path, int source, const std::vector<long long> &dist,
+                     const std::vector<int> &parent, long long unreachable) {
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    int32_t header[4];
+    std::memcpy(header, "SPT1", 4);
+    header[1] = (int32_t)dist.size();
+    header[2] = source;
+    header[3] = 0;
+    std::vector<int64_t> d(dist.size());
+    for (size_t v = 0; v < dist.size(); ++v)
+        d[v] = dist[v] >= unreachable ? std::numeric_limits<int64_t>::max() : dist[v];
+    bool ok = std::fwrite(header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(d.data(), sizeof(int64_t), d.size(), f) == d.size() &&
+              std::fwrite(parent.data(), sizeof(int), parent.size(), f) == parent.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// Reads a file written by WriteSPT. Returns false if it is missing or not in the SPT1 format.
+inline bool ReadSPT(const std::string &path, int &source, std::vector<long long> &dist, std::vector<int> &parent) {
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int32_t header[4];
+    bool ok = std::fread(header, sizeof(header), 1, f) == 1 && std::memcmp(header, "SPT1", 4) == 0 && header[1] >= 0;
+    if (ok) {
+        source = header[2];
+        dist.resize(header[1]);
+        parent.resize(header[1]);
+        ok = std::fread(dist.data(), sizeof(int64_t), dist.size(), f) == dist.size() &&
+             std::fread(parent.data(), sizeof(int), parent.size(), f) == parent.size();
+    }
+    std::fclose(f);
+    return ok;
+}
+
+template<bool Enabled>
+class ParentTracker;
+
+template<>
+class ParentTracker<false> {
+public:
+    explicit ParentTracker(int) {}
+    void Record(int, int) {}
+    bool Dump(const std::string &, int, const std::vector<long long> &, long long) const { return true; }
+};
+
+template<>
+class ParentTracker<true> {
+public:
+    explicit ParentTracker(int vertexCount) : parent_(vertexCount, -1) {}
+    void Record(int v, int u) { parent_[v] = u; }
+    const std::vector<int> &Parents() const { return parent_; }
+
+    bool Dump(const std::string &path, int source, const std::vector<long long> &dist, long long unreachable) const {
+        return WriteSPT(path, source, dist, parent_, unreachable);
+    }
+
+private:
+    std::vector<int> parent_;
+};
@@ -8,6 +8,11 @@
  *  - random: To generate random numbers
  *  - fstream: Writing into files.
  *  - set: For the STL set class and its methods, used to store unique elements.
+ *  - cmath, string: Geometric edge skipping and command-line arguments.
+ *
+ *  Usage: ./testGenerator                          generates the graphs listed in main()
+ *         ./testGenerator N D neg [id] [seed]      generates one graph, e.g. ./testGenerator 100000 0.0002 false
+ *  The command-line form is what scaling_sweep.sh uses to build its grid of sizes and densities.
  *
  *  Author: H. Hristov
  *  Ruse, 2025
@@ -17,6 +22,8 @@
 #include <random>
 #include <fstream>
 #include <set>
+#include <cmath>
+#include <string>
 
 using namespace std;
 
@@ -34,13 +41,19 @@ private:
     uniform_int_distribution<int> distWeightNeg;
 
     /* DFS to traverse the graph.
-     * Used to check if the graoh is connected.
+     * Used to check if the graoh is connected. An explicit stack keeps it safe for N = 10^6.
      */
-    void dfs(int v, vector<bool>& visited) {
-        visited[v] = true;
-        for (const auto& [u, w] : adjList[v]) {
-            if (!visited[u]) {
-                dfs(u, visited);
+    void dfs(int start, vector<bool>& visited) {
+        vector<int> stack = {start};
+        visited[start] = true;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            for (const auto& [u, w] : adjList[v]) {
+                if (!visited[u]) {
+                    visited[u] = true;
+                    stack.push_back(u);
+                }
             }
         }
     }
@@ -56,45 +69,50 @@ private:
     }
 
 public:
-    GraphGenerator(int nodes, double density, bool negWeights)
+    GraphGenerator(int nodes, double density, bool negWeights, unsigned seed = static_cast<unsigned>(time(0)))
         : N(nodes), D(density), allowNegativeWeights(negWeights),
-          rng(static_cast<unsigned>(time(0))),
+          rng(seed),
           distProb(0.0, 1.0),
           distWeightPos(1, 10),
           distWeightNeg(-10, 10) {
         adjList.resize(N);
     }
 
-    // Generate a random connected graph
-    void generate_graph() {
-        while (true) {
+    /* Generate a random connected graph. Gives up after maxAttempts disconnected samples (a density below
+     * about ln(N) / N is almost never connected) and returns false.
+     */
+    bool generate_graph(int maxAttempts = 1000) {
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
             for (auto& neighbors : adjList) {
                 neighbors.clear();
             }
 
-            // Generate edges using Erdos-Renyi model
-            for (int u = 0; u < N; ++u) {
-                for (int v = u + 1; v < N; ++v) {
-                    if (distProb(rng) < D) {
-                        int weight;
-                        if (allowNegativeWeights) {
-                            do {
-                                weight = distWeightNeg(rng);
-                            } while (weight == 0); // Avoid zero weights
-                        } else {
-                            weight = distWeightPos(rng);
-                        }
-                        adjList[u].push_back({v, weight});
-                        adjList[v].push_back({u, weight}); // Undirected graph
+            // Generate edges using Erdos-Renyi model. Instead of a coin flip per pair, the gap to the next
+            // edge is drawn from the geometric distribution, so the work is O(N + M) rather than O(N^2).
+            double logMiss = D < 1.0 ? log(1.0 - D) : 0.0;
+            for (int u = 0; u < N && D > 0.0; ++u) {
+                for (long long v = u; ; ) {
+                    v += D < 1.0 ? 1 + static_cast<long long>(log(1.0 - distProb(rng)) / logMiss) : 1;
+                    if (v >= N) break;
+                    int weight;
+                    if (allowNegativeWeights) {
+                        do {
+                            weight = distWeightNeg(rng);
+                        } while (weight == 0); // Avoid zero weights
+                    } else {
+                        weight = distWeightPos(rng);
                     }
+                    adjList[u].push_back({static_cast<int>(v), weight});
+                    adjList[v].push_back({u, weight}); // Undirected graph
                 }
             }
 
             // Check if the graph is connected
             if (IsConnected()) {
-                break;
+                return true;
             }
         }
+        return false;
     }
 
     // Save the graph to a file in the current directory
@@ -127,7 +145,22 @@ public:
     }
 };
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc >= 4) {
+        int N = stoi(argv[1]);
+        double D = stod(argv[2]);
+        bool negative = string(argv[3]) == "true";
+        int id = argc > 4 ? stoi(argv[4]) : 1;
+        unsigned seed = argc > 5 ? static_cast<unsigned>(stoul(argv[5])) : static_cast<unsigned>(time(0));
+        GraphGenerator generator(N, D, negative, seed);
+        if (!generator.generate_graph()) {
+            cerr << "Error: no connected graph with N = " << N << " and D = " << D << " was found." << endl;
+            return 1;
+        }
+        generator.SaveToFile(".", id);
+        return 0;
+    }
+
     vector<pair<int, double>> sizeTests = {
         // {100, 0.1},
         // {1000, 0.1},